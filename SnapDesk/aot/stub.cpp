@@ -0,0 +1,9 @@
+#include "compiler/native.hpp"
+
+// The binary is built without a script, the scripts are interpreted
+
+const char native::SCRIPT_HASH[] = "";
+
+bool native::run(const decoder::Frame *frame, std::string &output){
+    return false;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file corpus.hpp
+ * @author Pagano Florian
+ * @brief Give the frames replayed by the benchmarks
+ * @version 0.1
+ * @date 2025
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#ifndef CORPUS_HPP
+#define CORPUS_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "os_communicator/replay.hpp"
+
+#define CORPUS_SIZE 4096 ///<The number of frames of the synthetic corpus
+#define CORPUS_APS 64 ///<The number of access points of the synthetic corpus
+
+namespace bench{
+    /**
+     * @brief Add an IE to a frame
+     * 
+     * @param frame the frame
+     * @param element_id the element id of the IE
+     * @param content the content of the IE
+     */
+    inline void add_ie(std::vector<uint8_t> &frame, uint8_t element_id, std::vector<uint8_t> content){
+        frame.push_back(element_id);
+        frame.push_back(content.size());
+        frame.insert(frame.end(), content.begin(), content.end());
+    }
+
+    /**
+     * @brief Build a corpus of beacons looking like the ones of a busy place
+     * 
+     * @return std::vector<std::vector<uint8_t>> the beacons, FCS included
+     */
+    inline std::vector<std::vector<uint8_t>> synthetic_corpus(){
+        std::mt19937 random(42);
+        std::vector<std::vector<uint8_t>> frames;
+
+        for(size_t i = 0; i < CORPUS_SIZE; ++i){
+            size_t ap = random() % CORPUS_APS;
+            std::vector<uint8_t> frame = {0x80, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+            for(size_t j = 0; j < 2; ++j){
+                std::vector<uint8_t> bssid = {0x02, 0x11, 0x22, 0x33, (uint8_t) (ap >> 8), (uint8_t) ap};
+                frame.insert(frame.end(), bssid.begin(), bssid.end());
+            }
+            frame.push_back(random());
+            frame.push_back(random());
+
+            // Fixed fields
+            for(size_t j = 0; j < 8; ++j)
+                frame.push_back(random());
+            frame.insert(frame.end(), {0x64, 0x00, 0x11, (uint8_t) (0x04 + ap % 2)});
+
+            // IEs, the same for every beacon of an AP
+            std::mt19937 ap_random(ap);
+            std::string ssid = "network-" + std::to_string(ap % 16);
+            add_ie(frame, 0, std::vector<uint8_t>(ssid.begin(), ssid.end()));
+            add_ie(frame, 1, {0x82, 0x84, 0x8B, 0x96, 0x0C, 0x12, 0x18, 0x24});
+            add_ie(frame, 3, {(uint8_t) (1 + ap % 11)});
+            add_ie(frame, 5, {0x00, 0x01, 0x00, 0x00});
+            add_ie(frame, 7, {'F', 'R', 0x20, 0x01, 0x0D, 0x14});
+            std::vector<uint8_t> ht(26);
+            for(uint8_t &byte : ht)
+                byte = ap_random();
+            add_ie(frame, 45, ht);
+            add_ie(frame, 48, {0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04, 0x01, 0x00, 0x00, 0x0F, 0xAC, 0x04, 0x01, 0x00, 0x00, 0x0F, 0xAC, 0x02, 0x0C, 0x00});
+            std::vector<uint8_t> vht(12);
+            for(uint8_t &byte : vht)
+                byte = ap_random();
+            add_ie(frame, 191, vht);
+            add_ie(frame, 221, {0x00, 0x50, 0xF2, 0x02, 0x01, 0x01, 0x00, 0x00, 0x03, 0xA4, 0x00, 0x00, 0x27, 0xA4, 0x00, 0x00, 0x42, 0x43, 0x5E, 0x00, 0x62, 0x32, 0x2F, 0x00});
+
+            // FCS
+            for(size_t j = 0; j < 4; ++j)
+                frame.push_back(random());
+
+            frames.push_back(frame);
+        }
+
+        return frames;
+    }
+
+    /**
+     * @brief Load the replay corpus from a pcap file, or build the synthetic one
+     * 
+     * @param argc the number of arguments of the benchmark
+     * @param argv the arguments of the benchmark, the first one can be a pcap file
+     * @return os_communicator::Replay the corpus
+     */
+    inline os_communicator::Replay load_corpus(int argc, char *argv[]){
+        if(argc > 1){
+            printf("corpus: %s\n", argv[1]);
+            return os_communicator::Replay(argv[1]);
+        }
+
+        printf("corpus: synthetic, %d beacons from %d access points\n", CORPUS_SIZE, CORPUS_APS);
+        return os_communicator::Replay(synthetic_corpus());
+    }
+
+    /**
+     * @brief Get the time in seconds since an arbitrary point
+     * 
+     * @return double the time in seconds
+     */
+    inline double now(){
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file decode_bench.cpp
+ * @author Pagano Florian
+ * @brief Compare the throughput of the per frame decoder and of the batch decoder, and check peek_field() against decode()
+ * @version 0.1
+ * @date 2025
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ * Usage: decode_bench [capture.pcap] [rounds]
+ * 
+ */
+
+#include "decoder/frame.hpp"
+#include "decoder/frame_batch.hpp"
+#include "compiler/filter.hpp"
+
+#include "corpus.hpp"
+
+#define DEFAULT_ROUNDS 20 ///<The number of times the corpus is decoded
+
+/**
+ * @brief Write bytes as the hex operand of a Filter block
+ *
+ * @param data the bytes
+ * @param size the number of bytes
+ * @return std::string the operand, as 0x0201
+ */
+static std::string to_operand(const uint8_t *data, size_t size){
+    static const char *DIGITS = "0123456789abcdef";
+    std::string operand = "0x";
+
+    for(size_t i = 0; i < size; ++i){
+        operand.push_back(DIGITS[data[i] >> 4]);
+        operand.push_back(DIGITS[data[i] & 0xF]);
+    }
+
+    return operand;
+}
+
+/**
+ * @brief Check that peek_field() finds the fields of decode(), and that a Require block on the OUI of the BSSID keeps the frame
+ *
+ * @param replay the corpus
+ */
+static void check_peek(const os_communicator::Replay &replay){
+    std::vector<decoder::Field> fields;
+    for(size_t i = 0; i < decoder::HEADER_FIELD_COUNT; ++i)
+        fields.push_back({decoder::FIELD_HEADER, i});
+    for(size_t i = 0; i < decoder::BODY_PAYLOAD; ++i)
+        fields.push_back({decoder::FIELD_BODY, i});
+    for(size_t i = 0; i < 256; ++i)
+        fields.push_back({decoder::FIELD_IE, i});
+
+    decoder::Frame frame;
+    const decoder::Field bssid = decoder::Frame::resolve_field("bssid");
+    size_t checked = 0;
+    size_t mismatches = 0;
+    size_t oui_mismatches = 0;
+
+    for(size_t i = 0; i < replay.size(); ++i){
+        frame.set_raw_data(replay.get_frames()[i], replay.get_sizes()[i]);
+        try{
+            frame.decode();
+        } catch(const std::exception &e){
+            continue;
+        }
+        checked++;
+
+        for(const decoder::Field &field : fields){
+            decoder::Span peeked, decoded;
+            bool is_peeked = frame.peek_field(field, peeked);
+            bool is_decoded = frame.get_field(field, decoded);
+
+            bool is_same = is_peeked == is_decoded && (!is_peeked || peeked.size == decoded.size);
+            for(size_t j = 0; is_same && is_peeked && j < peeked.size; ++j)
+                is_same = peeked.data[j] == decoded.data[decoder::Frame::is_peek_reversed(field) ? decoded.size - 1 - j : j];
+
+            mismatches += !is_same;
+        }
+
+        // The OUI is the first 3 bytes of the frame, the last 3 bytes written by a script
+        decoder::Span decoded;
+        if(!frame.get_field(bssid, decoded) || decoded.size != 6)
+            continue;
+
+        uint8_t oui[3] = {decoded.data[5], decoded.data[4], decoded.data[3]};
+        compiler::Filter require(true, "bssid", "Prefix", {to_operand(oui, 3)}, 1);
+        oui_mismatches += !require.accept(&frame);
+    }
+
+    printf("peek: %zu frames (%zu mismatches with decode, %zu OUI prefixes not matched)\n", checked, mismatches, oui_mismatches);
+}
+
+int main(int argc, char *argv[]){
+    os_communicator::Replay replay = bench::load_corpus(argc, argv);
+    size_t rounds = argc > 2 ? std::stoul(argv[2]) : DEFAULT_ROUNDS;
+    size_t count = replay.size();
+
+    check_peek(replay);
+
+    // Per frame
+    decoder::Frame frame;
+    size_t errors = 0;
+    size_t checksum = 0;
+
+    double start = bench::now();
+    for(size_t round = 0; round < rounds; ++round){
+        for(size_t i = 0; i < count; ++i){
+            frame.set_raw_data(replay.get_frames()[i], replay.get_sizes()[i]);
+            try{
+                frame.decode();
+                checksum += frame.get_value("sequence_control").to_size_t();
+            } catch(const std::exception &e){
+                errors++;
+            }
+        }
+    }
+    double per_frame = bench::now() - start;
+
+    // Batch
+    decoder::Frame_batch batch(count);
+    size_t batch_checksum = 0;
+
+    start = bench::now();
+    for(size_t round = 0; round < rounds; ++round){
+        batch.decode(replay.get_frames(), replay.get_sizes(), count);
+        const uint16_t *sequence_control = batch.get_sequence_control();
+        for(size_t i = 0; i < count; ++i)
+            batch_checksum += sequence_control[i];
+    }
+    double batched = bench::now() - start;
+
+    size_t frames = rounds * count;
+
+    printf("frames: %zu x %zu rounds (%zu per frame errors)\n", count, rounds, errors);
+    printf("per frame: %10.0f frames/s %8.1f ns/frame\n", frames / per_frame, 1e9 * per_frame / frames);
+    printf("batch:     %10.0f frames/s %8.1f ns/frame\n", frames / batched, 1e9 * batched / frames);
+    printf("speedup:   %10.1fx\n", per_frame / batched);
+
+    if(checksum != batch_checksum)
+        printf("warning: the decoders do not agree on the sequence controls\n");
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * @file eval_bench.cpp
+ * @author Pagano Florian
+ * @brief Measure the evaluation of a fingerprint script on decoded frames
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Usage: eval_bench [capture.pcap] [rounds] [script]
+ *
+ */
+
+#include "decoder/frame.hpp"
+#include "compiler/compiler.hpp"
+#include "compiler/vm.hpp"
+#include "compiler/native.hpp"
+#include "compiler/fingerprint_cache.hpp"
+
+#include "corpus.hpp"
+
+#define DEFAULT_ROUNDS 20 ///<The number of times the corpus is evaluated
+#define DEFAULT_SCRIPT "./code.txt" ///<The script evaluated
+#define BATCH_SIZES {1, 16, 256, 4096} ///<The sizes of the batches given to Vm::run_batch()
+
+int main(int argc, char *argv[]){
+    os_communicator::Replay replay = bench::load_corpus(argc, argv);
+    size_t rounds = argc > 2 ? std::stoul(argv[2]) : DEFAULT_ROUNDS;
+    std::string script = argc > 3 ? argv[3] : DEFAULT_SCRIPT;
+    size_t count = replay.size();
+
+    os_communicator::Communicator c_script(script);
+    compiler::Compiler compiler(&c_script);
+    executable_tree::Node *tree = compiler.get_executable_tree();
+    bytecode::Program *program = compiler.get_program(tree);
+    bytecode::Vm vm(program);
+
+    // Decode once, only the evaluation is measured
+    std::vector<decoder::Frame *> frames;
+    for(size_t i = 0; i < count; ++i){
+        decoder::Frame *frame = new decoder::Frame();
+        frame->set_raw_data(replay.get_frames()[i], replay.get_sizes()[i]);
+        try{
+            frame->decode();
+            frames.push_back(frame);
+        } catch(const std::exception &e){
+            delete frame;
+        }
+    }
+
+    size_t errors = 0;
+    size_t checksum = 0;
+
+    double start = bench::now();
+    for(size_t round = 0; round < rounds; ++round){
+        for(decoder::Frame *frame : frames){
+            try{
+                checksum += vm.run(frame).size();
+            } catch(const std::exception &e){
+                errors++;
+            }
+        }
+    }
+    double elapsed = bench::now() - start;
+
+    size_t evaluations = rounds * frames.size();
+
+    printf("script: %s, %zu instructions\n", script.c_str(), program->get_code().size());
+    printf("frames: %zu x %zu rounds (%zu errors, checksum %zu)\n", frames.size(), rounds, errors, checksum);
+    printf("vm: %10.0f frames/s %8.1f ns/frame\n", evaluations / elapsed, 1e9 * elapsed / evaluations);
+
+    // The vm behind the cache of the outputs by BSSID, checked against the vm alone
+    {
+        bytecode::Fingerprint_cache cache(program);
+        size_t mismatches = 0;
+
+        start = bench::now();
+        for(size_t round = 0; round < rounds; ++round){
+            for(decoder::Frame *frame : frames){
+                const std::vector<std::string> *outputs = cache.find(frame);
+                if(!outputs){
+                    vm.run(frame);
+                    outputs = &vm.get_outputs();
+                    cache.insert(*outputs);
+                }
+                checksum += (*outputs)[0].size();
+            }
+        }
+        elapsed = bench::now() - start;
+
+        for(decoder::Frame *frame : frames){
+            const std::vector<std::string> *outputs = cache.find(frame);
+            if(outputs && (*outputs)[0] != vm.run(frame))
+                mismatches++;
+        }
+
+        printf("cache: %7.0f frames/s %8.1f ns/frame (%.1f%% hits, %zu mismatches with the vm)\n", evaluations / elapsed, 1e9 * elapsed / evaluations,
+            100.0 * cache.get_hits() / (cache.get_hits() + cache.get_misses()), mismatches);
+    }
+
+    // The vm in column order, each batch cycles through the frames, checked against the vm frame by frame,
+    // with the SHA-256 of OpenSSL and then with the one of Sha256_multi
+    for(bool is_sha256_multi : {false, true}){
+        vm.set_sha256_multi(is_sha256_multi);
+        const char *sha256 = is_sha256_multi ? digest::Sha256_multi::get_name(digest::Sha256_multi::get_best_kernel()) : "openssl";
+
+        for(size_t batch_size : BATCH_SIZES){
+            size_t output_count = program->get_output_count();
+            std::vector<const decoder::Frame *> batch(batch_size);
+            std::vector<std::string> outputs(batch_size * output_count);
+            size_t batches = (evaluations + batch_size - 1) / batch_size;
+            size_t mismatches = 0;
+            size_t next = 0;
+
+            for(size_t i = 0; i < batch_size; ++i)
+                batch[i] = frames[(next + i) % frames.size()];
+            try{
+                vm.run_batch(batch.data(), batch_size, outputs.data());
+                for(size_t i = 0; i < batch_size; ++i){
+                    vm.run(batch[i]);
+                    for(size_t j = 0; j < output_count; ++j)
+                        if(outputs[i * output_count + j] != vm.get_outputs()[j])
+                            mismatches++;
+                }
+            } catch(const std::exception &e){
+                errors++;
+            }
+
+            start = bench::now();
+            for(size_t b = 0; b < batches; ++b){
+                for(size_t i = 0; i < batch_size; ++i)
+                    batch[i] = frames[(next + i) % frames.size()];
+                next = (next + batch_size) % frames.size();
+
+                try{
+                    vm.run_batch(batch.data(), batch_size, outputs.data());
+                    checksum += outputs[0].size();
+                } catch(const std::exception &e){
+                    errors++;
+                }
+            }
+            elapsed = bench::now() - start;
+
+            printf("batch %4zu %-7s: %6.0f frames/s %8.1f ns/frame (%zu mismatches with the vm)\n", batch_size, sha256, batches * batch_size / elapsed,
+                1e9 * elapsed / (batches * batch_size), mismatches);
+        }
+    }
+
+    // The native code of make aot, checked against the vm
+    if(compiler.get_hash() == native::SCRIPT_HASH){
+        std::string output;
+        size_t mismatches = 0;
+
+        for(decoder::Frame *frame : frames){
+            native::run(frame, output);
+            if(output != vm.run(frame))
+                mismatches++;
+        }
+
+        start = bench::now();
+        for(size_t round = 0; round < rounds; ++round){
+            for(decoder::Frame *frame : frames){
+                native::run(frame, output);
+                checksum += output.size();
+            }
+        }
+        elapsed = bench::now() - start;
+
+        printf("native: %6.0f frames/s %8.1f ns/frame (%zu mismatches with the vm)\n", evaluations / elapsed, 1e9 * elapsed / evaluations, mismatches);
+    }
+
+    for(decoder::Frame *frame : frames)
+        delete frame;
+    delete program;
+    delete tree;
+
+    return 0;
+}
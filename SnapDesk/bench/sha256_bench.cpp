@@ -0,0 +1,136 @@
+/**
+ * @file sha256_bench.cpp
+ * @author Pagano Florian
+ * @brief Check the kernels of Sha256_multi against OpenSSL and compare their throughput on short messages
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Usage: sha256_bench [messages] [rounds]
+ *
+ */
+
+#include <random>
+
+#include "digest/sha256_multi.hpp"
+
+#include "corpus.hpp"
+
+#define CHECKED_MESSAGES 20000 ///<The number of random messages checked against OpenSSL for each kernel
+#define CHECKED_MAX_SIZE 600 ///<The longest message checked, the padding takes one or two blocks below it
+#define DEFAULT_MESSAGES 4096 ///<The number of messages hashed at each round
+#define DEFAULT_ROUNDS 50 ///<The number of rounds measured
+#define MESSAGE_MIN_SIZE 50 ///<The shortest message measured, as a short fingerprint
+#define MESSAGE_MAX_SIZE 500 ///<The longest message measured, as the hex of a few IEs
+
+/**
+ * @brief Make random messages of random sizes
+ *
+ * @param generator the generator
+ * @param count the number of messages
+ * @param min_size the shortest size
+ * @param max_size the longest size
+ * @return std::vector<std::vector<uint8_t>> the messages
+ */
+static std::vector<std::vector<uint8_t>> make_messages(std::mt19937_64 &generator, size_t count, size_t min_size, size_t max_size){
+    std::uniform_int_distribution<size_t> size(min_size, max_size);
+    std::vector<std::vector<uint8_t>> messages(count);
+
+    for(std::vector<uint8_t> &message : messages){
+        message.resize(size(generator));
+        for(uint8_t &byte : message)
+            byte = (uint8_t) generator();
+    }
+
+    return messages;
+}
+
+/**
+ * @brief Hash messages with OpenSSL, one after the other
+ *
+ * @param hash the reused hash
+ * @param messages the messages
+ * @param digests the digests, one after the other
+ */
+static void digest_openssl(digest::Sha256 &hash, const std::vector<std::vector<uint8_t>> &messages, uint8_t *digests){
+    for(size_t i = 0; i < messages.size(); ++i){
+        hash.begin();
+        hash.update(messages[i].data(), messages[i].size());
+        hash.final(digests + i*SHA256_LENGTH);
+    }
+}
+
+int main(int argc, char *argv[]){
+    size_t count = argc > 1 ? std::stoul(argv[1]) : DEFAULT_MESSAGES;
+    size_t rounds = argc > 2 ? std::stoul(argv[2]) : DEFAULT_ROUNDS;
+    std::mt19937_64 generator(42);
+    digest::Sha256 hash;
+
+    const digest::Sha256_kernel kernels[] = {digest::SHA256_KERNEL_SCALAR, digest::SHA256_KERNEL_NEON, digest::SHA256_KERNEL_AVX2};
+
+    // Every size up to CHECKED_MAX_SIZE, so that each padding case is met
+    std::vector<std::vector<uint8_t>> checked = make_messages(generator, CHECKED_MESSAGES, 0, CHECKED_MAX_SIZE);
+    for(size_t i = 0; i <= CHECKED_MAX_SIZE && i < checked.size(); ++i)
+        checked[i].resize(i);
+
+    std::vector<const uint8_t *> pointers;
+    std::vector<size_t> sizes;
+    for(const std::vector<uint8_t> &message : checked){
+        pointers.push_back(message.data());
+        sizes.push_back(message.size());
+    }
+
+    std::vector<uint8_t> expected(checked.size() * SHA256_LENGTH);
+    std::vector<uint8_t> digests(checked.size() * SHA256_LENGTH);
+    digest_openssl(hash, checked, expected.data());
+
+    for(digest::Sha256_kernel kernel : kernels){
+        if(!digest::Sha256_multi::is_supported(kernel))
+            continue;
+
+        digest::Sha256_multi::digest(pointers.data(), sizes.data(), checked.size(), digests.data(), kernel);
+
+        size_t mismatches = 0;
+        for(size_t i = 0; i < checked.size(); ++i)
+            mismatches += memcmp(&expected[i*SHA256_LENGTH], &digests[i*SHA256_LENGTH], SHA256_LENGTH) != 0;
+        printf("check %-7s %zu messages of 0 to %d bytes (%zu mismatches with OpenSSL)\n", digest::Sha256_multi::get_name(kernel),
+            checked.size(), CHECKED_MAX_SIZE, mismatches);
+    }
+
+    // Throughput on messages of the sizes hashed by the scripts
+    std::vector<std::vector<uint8_t>> messages = make_messages(generator, count, MESSAGE_MIN_SIZE, MESSAGE_MAX_SIZE);
+    pointers.clear();
+    sizes.clear();
+    size_t bytes = 0;
+    for(const std::vector<uint8_t> &message : messages){
+        pointers.push_back(message.data());
+        sizes.push_back(message.size());
+        bytes += message.size();
+    }
+    digests.resize(count * SHA256_LENGTH);
+
+    double start = bench::now();
+    for(size_t round = 0; round < rounds; ++round)
+        digest_openssl(hash, messages, digests.data());
+    double openssl = bench::now() - start;
+
+    printf("messages: %zu of %d to %d bytes x %zu rounds\n", count, MESSAGE_MIN_SIZE, MESSAGE_MAX_SIZE, rounds);
+    printf("openssl: %10.0f messages/s %8.1f ns/message %8.1f MB/s\n", rounds * count / openssl, 1e9 * openssl / (rounds * count),
+        rounds * bytes / openssl / 1e6);
+
+    for(digest::Sha256_kernel kernel : kernels){
+        if(!digest::Sha256_multi::is_supported(kernel))
+            continue;
+
+        start = bench::now();
+        for(size_t round = 0; round < rounds; ++round)
+            digest::Sha256_multi::digest(pointers.data(), sizes.data(), count, digests.data(), kernel);
+        double elapsed = bench::now() - start;
+
+        printf("%-7s  %10.0f messages/s %8.1f ns/message %8.1f MB/s (%.2fx OpenSSL)\n", digest::Sha256_multi::get_name(kernel),
+            rounds * count / elapsed, 1e9 * elapsed / (rounds * count), rounds * bytes / elapsed / 1e6, openssl / elapsed);
+    }
+
+    return 0;
+}
@@ -0,0 +1,294 @@
+/**
+ * @file bytecode.hpp
+ * @author Pagano Florian
+ * @brief The flat program the executable tree is lowered to, executed by the Vm
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef BYTECODE_HPP
+#define BYTECODE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+#include "decoder/frame.hpp"
+#include "digest/hash.hpp"
+
+#define MAX_REGISTERS 0xFFFF ///<The number of registers a program can use
+#define WIDTH_UNKNOWN SIZE_MAX ///<The width of a register whose byte length is only known at runtime
+
+namespace bytecode{
+    /**
+     * @brief The operations of the Vm
+     *
+     */
+    enum Opcode : uint8_t {
+        OP_LOAD_CONST, ///<destination = the text constants[first]
+        OP_LOAD_FIELD, ///<destination = the bytes of fields[first], or empty if the field is null
+        OP_SLICE_BIT, ///<destination = third bits of first from the bit second, or empty if out of range
+        OP_SLICE_BYTE, ///<destination = third bytes of first from the byte second (from the end), or empty if out of range
+        OP_HASH_BEGIN, ///<start the hash of the slot first
+        OP_HASH_UPDATE, ///<add first to the hash of the slot second, as text (hex for binary values) if third is 1, as bytes otherwise
+        OP_HASH_FINAL, ///<destination = the digest of the slot first
+        OP_EMIT ///<the output second of the program is first
+    };
+
+    /**
+     * @brief How the bytes of a value are written as text
+     *
+     */
+    enum Encoding : uint8_t {
+        ENCODING_TEXT, ///<The bytes are the text, as the constants of the script
+        ENCODING_HEX_UPPER, ///<The bytes are binary, written as uppercase hex (fields and cuts)
+        ENCODING_HEX_LOWER ///<The bytes are binary, written as lowercase hex (hashes)
+    };
+
+    /**
+     * @brief A constant value of a program
+     *
+     */
+    struct Constant {
+        std::string bytes; ///<The bytes of the value
+        Encoding encoding; ///<How the value is written as text
+    };
+
+    /**
+     * @brief A hash of a program
+     *
+     */
+    struct Hash_slot {
+        digest::Algorithm algorithm; ///<The algorithm
+        std::string key; ///<The key of the keyed algorithms, empty for the others
+    };
+
+    /**
+     * @brief One operation of a program, the operands are register numbers unless stated otherwise
+     *
+     */
+    struct Instruction {
+        Opcode opcode; ///<The operation
+        uint16_t destination; ///<The register written by the operation
+        uint16_t first; ///<The first operand
+        uint16_t second; ///<The second operand
+        uint16_t third; ///<The third operand
+        uint16_t script; ///<The script whose node emitted the operation, for the profile
+        uint32_t line; ///<The line of the node which emitted the operation, 0 for the output of a script
+    };
+
+    /**
+     * @brief A linear program computing the fingerprint of a frame, built by lowering an executable tree
+     * @class Program
+     *
+     * Every value gets its own register, so the registers never alias. A field, a constant or a cut
+     * is loaded once and its register is shared by all its uses, even by the different scripts of a program.
+     *
+     */
+    class Program {
+        private:
+            std::vector<Instruction> _code; ///<The instructions, executed in order
+            std::vector<Constant> _constants; ///<The constant values
+            std::vector<decoder::Field> _fields; ///<The resolved fields read by the program
+            std::vector<std::string> _field_names; ///<The names of the fields, for to_string()
+            std::vector<Hash_slot> _hashes; ///<The hashes, one slot per hash of the script
+            size_t _register_count = 0; ///<The number of registers used
+            std::vector<size_t> _widths; ///<The byte length of each register when not null, or WIDTH_UNKNOWN
+            std::vector<size_t> _register_constants; ///<The constant loaded in each register, or _constants.size() if none
+            size_t _output_count = 0; ///<The number of outputs, one per script and per Output block
+            uint16_t _script = 0; ///<The script of the next instructions
+            uint32_t _line = 0; ///<The line of the next instructions
+            std::map<std::pair<std::string, Encoding>, uint16_t> _constant_registers; ///<The register of each constant
+            std::map<std::pair<decoder::Field_kind, size_t>, uint16_t> _field_registers; ///<The register of each field
+            std::map<std::tuple<Opcode, uint16_t, uint16_t, uint16_t>, uint16_t> _slice_registers; ///<The register of each cut
+            std::map<std::tuple<digest::Algorithm, std::string, std::vector<std::pair<uint16_t, uint16_t>>>, uint16_t> _hash_registers; ///<The register of each hash, by its algorithm, its key and its updates
+
+        public:
+            /**
+             * @brief Get a new register
+             *
+             * @param width the byte length of the values of the register, when not null
+             * @return uint16_t the number of the register
+             */
+            uint16_t new_register(size_t width = WIDTH_UNKNOWN);
+            /**
+             * @brief Load a constant in a new register
+             *
+             * @param bytes the bytes of the constant
+             * @param encoding how the constant is written as text
+             * @return uint16_t the register
+             */
+            uint16_t load_constant(const std::string &bytes, Encoding encoding);
+            /**
+             * @brief Resolve a field and load it in a new register
+             *
+             * @param name the name of the field, as given to Frame::get_value()
+             * @return uint16_t the register
+             */
+            uint16_t load_field(const std::string &name);
+            /**
+             * @brief Cut a value in a new register
+             *
+             * @param opcode OP_SLICE_BIT or OP_SLICE_BYTE
+             * @param source the register of the value
+             * @param from the first bit or byte
+             * @param size the number of bits or bytes
+             * @return uint16_t the register
+             */
+            uint16_t slice(Opcode opcode, uint16_t source, uint16_t from, uint16_t size);
+            /**
+             * @brief Get a new output, for the next script or Output block lowered in the program
+             *
+             * @return uint16_t the index of the output
+             */
+            uint16_t add_output();
+            /**
+             * @brief Get a new hash slot
+             *
+             * @param algorithm the algorithm of the hash
+             * @param key the key of the keyed algorithms, empty for the others
+             * @return uint16_t the hash slot
+             */
+            uint16_t add_hash(digest::Algorithm algorithm, const std::string &key);
+            /**
+             * @brief Finish a hash in a new register, or reuse the register of the same hash computed before
+             *
+             * Two hashes are the same if they have the same algorithm and key and are updated with the same registers
+             * in the same way, as the fields and the cuts are already shared. The instructions of a hash already
+             * computed are removed, with its slot and its register.
+             *
+             * @param slot the hash slot
+             * @param begin the position of the OP_HASH_BEGIN of the hash in the code
+             * @return uint16_t the register holding the digest
+             */
+            uint16_t final_hash(uint16_t slot, size_t begin);
+            /**
+             * @brief Set the script of the next instructions
+             *
+             * @param script the index of the script
+             */
+            void set_script(uint16_t script);
+            /**
+             * @brief Set the line of the next instructions
+             *
+             * @param line the line of the node being lowered
+             * @return uint32_t the line of the instructions until now
+             */
+            uint32_t set_line(uint32_t line);
+            /**
+             * @brief Append an instruction to the program
+             *
+             * @param opcode the operation
+             * @param destination the register written
+             * @param first the first operand
+             * @param second the second operand
+             * @param third the third operand
+             */
+            void emit(Opcode opcode, uint16_t destination, uint16_t first = 0, uint16_t second = 0, uint16_t third = 0);
+
+            /**
+             * @brief Get the instructions
+             *
+             * @return const std::vector<Instruction>& the instructions
+             */
+            const std::vector<Instruction> &get_code() const;
+            /**
+             * @brief Get the constant values
+             *
+             * @return const std::vector<Constant>& the constants
+             */
+            const std::vector<Constant> &get_constants() const;
+            /**
+             * @brief Get the resolved fields
+             *
+             * @return const std::vector<decoder::Field>& the fields
+             */
+            const std::vector<decoder::Field> &get_fields() const;
+            /**
+             * @brief Get the hash slots
+             *
+             * @return const std::vector<Hash_slot>& the hashes
+             */
+            const std::vector<Hash_slot> &get_hashes() const;
+            /**
+             * @brief Get the number of outputs
+             *
+             * @return size_t the number of outputs, one per script and per Output block
+             */
+            size_t get_output_count() const;
+            /**
+             * @brief Get the number of registers used
+             *
+             * @return size_t the number of registers
+             */
+            size_t get_register_count() const;
+            /**
+             * @brief Get the byte length of the values of a register, known at compile time
+             *
+             * @param value the register
+             * @return size_t the byte length when the value is not null, or WIDTH_UNKNOWN
+             */
+            size_t get_width(uint16_t value) const;
+            /**
+             * @brief Get the constant loaded in a register
+             *
+             * @param value the register
+             * @return const Constant* the constant, or nullptr if the register is computed at runtime
+             */
+            const Constant *get_constant(uint16_t value) const;
+
+            /**
+             * @brief Remove the instructions whose result is never used, as the loads of folded constants
+             *
+             */
+            void remove_unused();
+            /**
+             * @brief Get the values read by several instructions, computed once and shared
+             *
+             * @return std::string one line per shared register, with the number of instructions reading it
+             */
+            std::string get_shared_values() const;
+
+            /**
+             * @brief Write the program as bytes, read back by deserialize()
+             *
+             * The fields are written by name and resolved again when read, the other parts as they are.
+             *
+             * @return std::string the bytes of the program
+             */
+            std::string serialize() const;
+            /**
+             * @brief Read a program written by serialize(), every operand is checked so a damaged program is rejected
+             *
+             * The program read can be run and printed, but not extended.
+             *
+             * @param data the bytes of the program
+             * @param size the number of bytes
+             * @return Program* the program
+             */
+            static Program *deserialize(const uint8_t *data, size_t size);
+
+            /**
+             * @brief Get the listing of the program
+             *
+             * @return std::string one line per instruction
+             */
+            std::string to_string() const;
+            /**
+             * @brief Get the listing of the program, each line prefixed by an annotation
+             *
+             * @param annotations the annotation of each instruction
+             * @return std::string one line per instruction
+             */
+            std::string to_string(const std::vector<std::string> &annotations) const;
+    };
+}
+
+#endif
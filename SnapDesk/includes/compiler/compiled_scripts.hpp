@@ -0,0 +1,168 @@
+/**
+ * @file compiled_scripts.hpp
+ * @author Pagano Florian
+ * @brief Everything built from the scripts, replaced as a whole when a script is reloaded
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef COMPILED_SCRIPTS_HPP
+#define COMPILED_SCRIPTS_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <stdexcept>
+
+#include "os_communicator/os_communicator.hpp"
+#include "compiler/compiler.hpp"
+#include "compiler/vm.hpp"
+#include "compiler/native.hpp"
+#include "compiler/fingerprint_cache.hpp"
+#include "compiler/program_cache.hpp"
+#include "compiler/filter.hpp"
+#include "decoder/frame.hpp"
+
+namespace compiler {
+    /**
+     * @brief The scripts compiled to one program, with the Vm, the native code and the cache running it
+     * @class Compiled_scripts
+     *
+     * A Compiled_scripts is built in one go and never modified, except by run(), so a new one can be
+     * compiled by another thread while the current one runs, and swapped between two frames.
+     *
+     */
+    class Compiled_scripts {
+        private:
+            std::vector<std::string> _scripts; ///<The paths of the scripts
+            std::vector<std::string> _hashes; ///<The hash of each script, as given by Compiler::get_hash()
+            std::vector<os_communicator::Communicator *> _communicators; ///<The communicators to the scripts
+            std::vector<Compiler *> _compilers; ///<The compilers of the scripts
+            std::vector<const executable_tree::Node *> _trees; ///<The executable tree of each script, empty if the program is loaded from its cache
+            std::vector<std::vector<std::string>> _output_names; ///<The names of the Output blocks of each script
+            std::vector<size_t> _output_positions; ///<The position of the output of each script in the outputs of the program
+            std::vector<std::vector<Filter *>> _filters; ///<The Filter and Require blocks of each script
+            std::vector<bool> _is_accepted; ///<true for each script keeping the last filtered frame
+            bytecode::Program *_program = nullptr; ///<The program of all the scripts
+            std::string _cache_file_name; ///<The file saving the program, next to the first script
+            bool _is_cached = false; ///<true if the program is loaded from its cache file, without building the trees
+            bytecode::Vm *_vm = nullptr; ///<The Vm running the program
+            bytecode::Fingerprint_cache *_cache = nullptr; ///<The outputs by BSSID
+            bool _is_native = false; ///<true if the script is the one compiled in the binary
+            bool _is_profiling = false; ///<true if the Vm records the profile of the instructions
+            std::vector<std::string> _native_outputs; ///<The output of the native code
+
+            /**
+             * @brief Delete everything built
+             *
+             */
+            void _clear();
+
+        public:
+            /**
+             * @brief Compile scripts
+             *
+             * The program is loaded from the cache file next to the first script if it was saved for the same scripts,
+             * otherwise it is compiled and saved there.
+             *
+             * @param scripts the paths of the scripts
+             * @param is_profiling true to record the profile of the program, which is then always interpreted and compiled
+             * @param is_cache_loaded false to compile the scripts without reading nor writing their saved program, to print their trees
+             */
+            Compiled_scripts(const std::vector<std::string> &scripts, bool is_profiling = false, bool is_cache_loaded = true);
+            /**
+             * @brief Destroy the Compiled_scripts object
+             *
+             */
+            ~Compiled_scripts();
+
+            Compiled_scripts(const Compiled_scripts &) = delete;
+            Compiled_scripts &operator=(const Compiled_scripts &) = delete;
+
+            /**
+             * @brief Run the Filter and Require blocks of each script on a validated frame, before decoding it
+             *
+             * @param frame the validated frame
+             * @return true if at least one script keeps the frame, false if it can be skipped without decoding it
+             */
+            bool filter(const decoder::Frame *frame);
+            /**
+             * @brief Tell if the program is loaded from its cache file
+             *
+             * @return true if the program was saved by a previous start, the trees are then not built
+             */
+            bool is_cached() const;
+            /**
+             * @brief Tell if a script keeps the last filtered frame
+             *
+             * @param script the index of the script
+             * @return true if the outputs of the script are stored for the frame
+             */
+            bool is_accepted(size_t script) const;
+            /**
+             * @brief Compute the outputs of the scripts on a frame, from the cache when possible
+             *
+             * @param frame the decoded frame
+             * @return const std::vector<std::string>& the outputs of the program, valid until the next run, see get_output_position()
+             */
+            const std::vector<std::string> &run(const decoder::Frame *frame);
+
+            /**
+             * @brief Get the paths of the scripts
+             *
+             * @return const std::vector<std::string>& the paths
+             */
+            const std::vector<std::string> &get_scripts() const;
+            /**
+             * @brief Get the hashes of the scripts
+             *
+             * @return const std::vector<std::string>& the hash of each script
+             */
+            const std::vector<std::string> &get_hashes() const;
+            /**
+             * @brief Get the names of the Output blocks of each script
+             *
+             * @return const std::vector<std::vector<std::string>>& the names of the Output blocks of each script
+             */
+            const std::vector<std::vector<std::string>> &get_output_names() const;
+            /**
+             * @brief Get the position of the output of a script in the outputs given by run()
+             *
+             * The output of the script is followed by the value of each of its Output blocks.
+             *
+             * @param script the index of the script
+             * @return size_t the position
+             */
+            size_t get_output_position(size_t script) const;
+            /**
+             * @brief Get the cache of the outputs
+             *
+             * @return const bytecode::Fingerprint_cache* the cache
+             */
+            const bytecode::Fingerprint_cache *get_cache() const;
+
+            /**
+             * @brief Print the trees, the program, the values it shares and how it is run
+             *
+             */
+            void print() const;
+            /**
+             * @brief Print the number of frames skipped by each Filter and Require block
+             *
+             */
+            void print_filters() const;
+            /**
+             * @brief Print the profile of the runs of the Vm on the trees and on the program, if it is recorded
+             *
+             * The instructions are summed by node, a field or a cut shared by several nodes counts for the first one.
+             *
+             */
+            void print_profile() const;
+    };
+}
+
+#endif
@@ -4,7 +4,11 @@
 #include "os_communicator/os_communicator.hpp"
 #include "compiler/node.hpp"
 #include "compiler/function_node.hpp"
+#include "compiler/bytecode.hpp"
+#include "compiler/lexer.hpp"
+#include "compiler/filter.hpp"
 #include "decoder/frame.hpp"
+#include "digest/sha256.hpp"
 
 namespace compiler {
     /**
@@ -15,28 +19,59 @@ namespace compiler {
     class Compiler {
         private:
             const os_communicator::Communicator *_communicator; ///<Communicator to the source code
+            Lexer *_lexer = nullptr; ///<The tokens and the hash of the source code, read once
 
-            // return the next line to read and fill the current_node
             /**
-             * @brief Contruct the executable tree
+             * @brief Parse a node and its arguments
              * 
-             * @param current_node the node to attach the result
-             * @param next_line the next line number to read
-             * @return size_t the next line to read
+             * @param position the position of the first token of the node, set to the position of the token after it
+             * @return executable_tree::Node* the node
              */
-            size_t read_line(executable_tree::Node *current_node, size_t next_line) const;
+            executable_tree::Node *parse_node(size_t &position) const;
+            /**
+             * @brief Tell if a token begins a Filter or a Require block
+             * 
+             * @param token the token
+             * @return true if the token is "Filter {" or "Require {"
+             */
+            static bool is_filter(const Token &token);
+            /**
+             * @brief Parse a Filter or a Require block
+             * 
+             * @param position the position of the beginning of the block, set to the position of the token after it
+             * @return Filter* the block
+             */
+            Filter *parse_filter(size_t &position) const;
+            /**
+             * @brief Tell if a token begins an Output block
+             * 
+             * @param token the token
+             * @return true if the token is "Output <name> {"
+             */
+            static bool is_output(const Token &token);
+            /**
+             * @brief Parse an Output block
+             * 
+             * @param position the position of the beginning of the block, set to the position of the token after it
+             * @return executable_tree::Node* the executable_tree::Output node of the block
+             */
+            executable_tree::Node *parse_output(size_t &position) const;
 
         public:
             /**
-             * @brief Construct a new Compiler object
+             * @brief Construct a new Compiler object, the source code is read and split into tokens
              * 
              * @param communicator Communicator to source code
              */
-            Compiler(const os_communicator::Communicator *communicator) 
-            : _communicator(communicator) {
-                if(!_communicator)
-                    throw invalid_argument("No communicator given");
-            };
+            Compiler(const os_communicator::Communicator *communicator);
+            /**
+             * @brief Destroy the Compiler object
+             * 
+             */
+            ~Compiler();
+
+            Compiler(const Compiler &) = delete;
+            Compiler &operator=(const Compiler &) = delete;
 
             /**
              * @brief Compile the source code to get the executable tree
@@ -44,6 +79,49 @@ namespace compiler {
              * @return executable_tree::Node* the executable tree corresponding to the source code
              */
             executable_tree::Node *get_executable_tree() const;
+            /**
+             * @brief Compile the Filter and Require blocks at the beginning of the source code
+             * 
+             * @return std::vector<Filter *> the blocks, in the order of the source code
+             */
+            std::vector<Filter *> get_filters() const;
+            /**
+             * @brief Get the names of the Output blocks following the result of the source code
+             * 
+             * @return std::vector<std::string> the names, in the order of the outputs of the tree after the result
+             */
+            std::vector<std::string> get_output_names() const;
+            /**
+             * @brief Lower an executable tree to the bytecode program executed by a bytecode::Vm
+             * 
+             * @param tree the executable tree given by get_executable_tree()
+             * @return bytecode::Program* the program computing the same value as the tree
+             */
+            bytecode::Program *get_program(const executable_tree::Node *tree) const;
+            /**
+             * @brief Lower the executable trees of several scripts to a single program, the output i is the value of the tree i
+             * 
+             * The fields, constants and cuts used by several scripts are computed once.
+             * 
+             * @param trees the executable trees given by the compilers of the scripts
+             * @return bytecode::Program* the program computing the values of all the trees
+             */
+            static bytecode::Program *get_program(const std::vector<const executable_tree::Node *> &trees);
+            /**
+             * @brief Get the hash of the source code, the name of the folder of its databases
+             * 
+             * @return std::string the SHA-256 of the lines until the first blank line, in lowercase hex
+             */
+            std::string get_hash() const;
+            /**
+             * @brief Translate a program to a C++ translation unit implementing native::run() (snapdesk-codegen)
+             * 
+             * The fields, the cut positions and the constants are written as compile-time constants.
+             * 
+             * @param program the program given by get_program(), for this script only and without Output block
+             * @return std::string the source of the translation unit
+             */
+            std::string get_native_source(const bytecode::Program *program) const;
     };
 }
 
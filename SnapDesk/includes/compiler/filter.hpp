@@ -0,0 +1,98 @@
+/**
+ * @file filter.hpp
+ * @author Pagano Florian
+ * @brief The Filter and Require blocks of a script, evaluated on the raw frame before decoding it
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef FILTER_HPP
+#define FILTER_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+#include "decoder/frame.hpp"
+
+namespace compiler {
+    /**
+     * @brief The tests of a Filter on the value of its field
+     *
+     */
+    enum Predicate {
+        PREDICATE_EQUALS, ///<the value is the operand
+        PREDICATE_IN, ///<the value is one of the operands
+        PREDICATE_PREFIX, ///<the value begins with one of the operands
+        PREDICATE_EXISTS ///<the field is in the frame
+    };
+
+    /**
+     * @brief A block "Filter {" or "Require {" of a script
+     * @class Filter
+     *
+     * A Require block skips the frames whose field does not match, a Filter block skips the frames
+     * whose field matches. The field is read in the raw frame, so the skipped frames are never decoded.
+     *
+     */
+    class Filter {
+        private:
+            bool _is_require; ///<true for Require, false for Filter
+            std::string _field_name; ///<The name of the field, for to_string()
+            decoder::Field _field; ///<The field tested
+            bool _is_reversed; ///<true if the operands are written in the reverse order of the raw bytes of the field
+            Predicate _predicate; ///<The test
+            std::vector<std::string> _operands; ///<The bytes of the operands, in the order of the raw frame
+            std::vector<std::string> _texts; ///<The operands as written in the script
+            size_t _line; ///<The line of the block in the script
+            size_t _skipped = 0; ///<The number of frames skipped by the block
+
+            /**
+             * @brief Test the value of the field
+             *
+             * @param span the raw bytes of the field
+             * @return true if the value matches the predicate
+             */
+            bool _match(const decoder::Span &span) const;
+
+        public:
+            /**
+             * @brief Construct a new Filter object
+             *
+             * @param is_require true for Require, false for Filter
+             * @param field_name the name of the field, as in a getter
+             * @param predicate_name Equals, In, Prefix or Exists
+             * @param operands the operands, as text or as hex digits after 0x
+             * @param line the line of the block in the script
+             */
+            Filter(bool is_require, const std::string &field_name, const std::string &predicate_name, const std::vector<std::string> &operands, size_t line);
+
+            /**
+             * @brief Tell if a frame passes the block, and count it if not
+             *
+             * @param frame the validated frame, not necessarily decoded
+             * @return true if the frame is kept
+             */
+            bool accept(const decoder::Frame *frame);
+            /**
+             * @brief Get the number of frames skipped by the block
+             *
+             * @return size_t the number of frames
+             */
+            size_t get_skipped() const;
+            /**
+             * @brief Get the block as written in a script, on one line
+             *
+             * @return std::string the block
+             */
+            std::string to_string() const;
+    };
+}
+
+#endif
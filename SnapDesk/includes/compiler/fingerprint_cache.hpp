@@ -0,0 +1,110 @@
+/**
+ * @file fingerprint_cache.hpp
+ * @author Pagano Florian
+ * @brief The last fingerprints of each BSSID, reused while the fields read by the scripts do not change
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef FINGERPRINT_CACHE_HPP
+#define FINGERPRINT_CACHE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <stdexcept>
+
+#include "compiler/bytecode.hpp"
+#include "decoder/frame.hpp"
+#include "digest/xxh64.hpp"
+
+#define FINGERPRINT_CACHE_DEFAULT_CAPACITY 4096 ///<The number of BSSIDs remembered by default
+
+namespace bytecode{
+    /**
+     * @brief A cache of the outputs of a program, one entry per BSSID
+     * @class Fingerprint_cache
+     *
+     * The key of a frame is made of the bytes of every field the program reads, so the fields it
+     * does not read (as the timestamp or the sequence number) do not change the key.
+     * The XXH64 of the key is compared first, then the key itself, so a hit always gives the outputs
+     * the program would give.
+     *
+     */
+    class Fingerprint_cache {
+        private:
+            /**
+             * @brief The last frame seen for a BSSID
+             *
+             */
+            struct Entry {
+                uint64_t digest; ///<The XXH64 of key
+                std::string key; ///<The bytes of the fields read by the program
+                std::vector<std::string> outputs; ///<The outputs of the program
+            };
+
+            const Program *_program; ///<The program whose outputs are cached
+            decoder::Field _bssid; ///<The resolved BSSID field
+            size_t _capacity; ///<The max number of entries
+            std::unordered_map<uint64_t, Entry> _entries; ///<The entries, by BSSID
+            digest::Xxh64 _hash; ///<The hash of the keys
+
+            std::string _key; ///<The key of the last frame looked up
+            uint64_t _digest; ///<The XXH64 of _key
+            uint64_t _bssid_value; ///<The BSSID of the last frame looked up
+            bool _is_cacheable; ///<false if the last frame looked up has no BSSID
+
+            size_t _hits = 0; ///<The number of outputs found in the cache
+            size_t _misses = 0; ///<The number of outputs computed
+            size_t _evictions = 0; ///<The number of entries removed to make room
+
+        public:
+            /**
+             * @brief Construct a new Fingerprint_cache object
+             *
+             * @param program the program whose outputs are cached, it must outlive the cache
+             * @param capacity the max number of BSSIDs remembered
+             */
+            Fingerprint_cache(const Program *program, size_t capacity = FINGERPRINT_CACHE_DEFAULT_CAPACITY);
+
+            /**
+             * @brief Look for the outputs of the program on a frame
+             *
+             * @param frame the decoded frame
+             * @return const std::vector<std::string>* the outputs, valid until the next insert(), or nullptr if they must be computed
+             */
+            const std::vector<std::string> *find(const decoder::Frame *frame);
+            /**
+             * @brief Remember the outputs of the program on the frame of the last find() that returned nullptr
+             *
+             * @param outputs the outputs
+             */
+            void insert(const std::vector<std::string> &outputs);
+
+            /**
+             * @brief Get the number of outputs found in the cache
+             *
+             * @return size_t the number of hits
+             */
+            size_t get_hits() const;
+            /**
+             * @brief Get the number of outputs computed
+             *
+             * @return size_t the number of misses
+             */
+            size_t get_misses() const;
+            /**
+             * @brief Print the hit rate
+             *
+             */
+            void print() const;
+    };
+}
+
+#endif
@@ -14,9 +14,10 @@
 #include "compiler/node.hpp"
 #include "decoder/big_number.hpp"
 
-#include <openssl/evp.h>
 #include <string>
 
+#define MAX_CUT_BITS (8*FRAME_MAX_LENGTH) ///<No value of a frame is longer than the frame itself
+
 namespace executable_tree{
     /**
      * @brief This Function concatenates its arguments and 
@@ -27,7 +28,75 @@ namespace executable_tree{
         public:
             std::string to_string(size_t depth) const override;
 
-            std::string get_value(const decoder::Frame *target_frame) const override;
+            uint16_t lower(bytecode::Program &program) const override;
+    } ;
+
+    /**
+     * @brief This Function concatenates the bytes of its arguments and returns their SHA-256 hash
+     * @class Sha256_raw
+     * 
+     * Unlike Sha256, the fields and the cuts are hashed as binary instead of as hex text, so the hashes differ.
+     * 
+     */
+    class Sha256_raw : public Function {
+        public:
+            std::string to_string(size_t depth) const override;
+
+            uint16_t lower(bytecode::Program &program) const override;
+    } ;
+
+    /**
+     * @brief This Function returns the XXH64 hash of the bytes of its arguments, on 8 bytes
+     * @class Xxh64
+     * 
+     * As Sha256_raw, the fields and the cuts are hashed as binary. It is not a cryptographic hash.
+     * 
+     */
+    class Xxh64 : public Function {
+        public:
+            std::string to_string(size_t depth) const override;
+
+            uint16_t lower(bytecode::Program &program) const override;
+    } ;
+
+    /**
+     * @brief This Function returns two XXH64 hashes with different seeds of the bytes of its arguments, on 16 bytes
+     * @class Xxh128
+     * 
+     */
+    class Xxh128 : public Function {
+        public:
+            std::string to_string(size_t depth) const override;
+
+            uint16_t lower(bytecode::Program &program) const override;
+    } ;
+
+    /**
+     * @brief This Function returns the SipHash-2-4 of the bytes of its arguments, on 8 bytes
+     * @class Siphash64
+     * 
+     * The first arg is the key, 32 hex digits, the other args are hashed.
+     * 
+     */
+    class Siphash64 : public Function {
+        public:
+            std::string to_string(size_t depth) const override;
+
+            uint16_t lower(bytecode::Program &program) const override;
+    } ;
+
+    /**
+     * @brief This Function returns the SipHash-2-4 of the bytes of its arguments, on 16 bytes
+     * @class Siphash128
+     * 
+     * The first arg is the key, 32 hex digits, the other args are hashed.
+     * 
+     */
+    class Siphash128 : public Function {
+        public:
+            std::string to_string(size_t depth) const override;
+
+            uint16_t lower(bytecode::Program &program) const override;
     } ;
 
     /**
@@ -38,7 +107,7 @@ namespace executable_tree{
         public:
             std::string to_string(size_t depth) const override;
 
-            std::string get_value(const decoder::Frame *target_frame) const override;
+            uint16_t lower(bytecode::Program &program) const override;
     } ;
 
     /**
@@ -49,7 +118,32 @@ namespace executable_tree{
         public:
             std::string to_string(size_t depth) const override;
 
-            std::string get_value(const decoder::Frame *target_frame) const override;
+            uint16_t lower(bytecode::Program &program) const override;
+    } ;
+
+    /**
+     * @brief This Function takes no arg and returns the element ids of the IEs in their order, as the field ie_order
+     * @class Ie_order
+     * 
+     * Each id is followed by the extension id for the IE 255 and by the OUI for the IE 221. The order is recorded
+     * when the frame is decoded, so it costs one field read instead of a getter per IE.
+     */
+    class Ie_order : public Function {
+        public:
+            std::string to_string(size_t depth) const override;
+
+            uint16_t lower(bytecode::Program &program) const override;
+    } ;
+
+    /**
+     * @brief This Function takes no arg and returns the set of the element ids of the IEs on 32 bytes, as the field ie_set
+     * @class Ie_set
+     */
+    class Ie_set : public Function {
+        public:
+            std::string to_string(size_t depth) const override;
+
+            uint16_t lower(bytecode::Program &program) const override;
     } ;
 }
 
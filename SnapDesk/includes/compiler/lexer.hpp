@@ -0,0 +1,82 @@
+/**
+ * @file lexer.hpp
+ * @author Pagano Florian
+ * @brief Split the source code into tokens, in one pass
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef LEXER_HPP
+#define LEXER_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "digest/sha256.hpp"
+
+namespace compiler {
+    /**
+     * @brief The kinds of token, one per line of source code
+     *
+     */
+    enum Token_kind {
+        TOKEN_BEGIN, ///<"<name> {", the beginning of a function
+        TOKEN_END, ///<"}", the end of a function
+        TOKEN_GETTER, ///<">field", the value of a field of the frame
+        TOKEN_VALUE, ///<any other line, a constant
+        TOKEN_END_OF_SCRIPT ///<the end of the file or the first empty line
+    };
+
+    /**
+     * @brief A token of the source code
+     * @struct Token
+     *
+     */
+    struct Token {
+        Token_kind kind; ///<The kind of the token
+        std::string text; ///<The name of the function, the field or the constant
+        size_t line; ///<The line of the token, from 1
+    };
+
+    /**
+     * @brief Split the source code into tokens, and hash it in the same pass
+     * @class Lexer
+     *
+     * The script ends at the first empty line, the lines starting with '#' are comments. The hash is the SHA-256
+     * of the lines of the script, comments included and newlines excluded, so the folder of the databases of a
+     * script does not change with this lexer.
+     *
+     */
+    class Lexer {
+        private:
+            std::vector<Token> _tokens; ///<The tokens, the last one is TOKEN_END_OF_SCRIPT
+            std::string _hash; ///<The lowercase hex of the hash of the script
+
+        public:
+            /**
+             * @brief Construct a new Lexer object
+             *
+             * @param source the content of the script
+             */
+            Lexer(const std::string &source);
+
+            /**
+             * @brief Get the tokens of the script
+             *
+             * @return const std::vector<Token>& the tokens, ended by a TOKEN_END_OF_SCRIPT
+             */
+            const std::vector<Token> &get_tokens() const;
+            /**
+             * @brief Get the hash of the script
+             *
+             * @return const std::string& the SHA-256 of the lines of the script, in lowercase hex
+             */
+            const std::string &get_hash() const;
+    };
+}
+
+#endif
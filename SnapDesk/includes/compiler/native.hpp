@@ -0,0 +1,138 @@
+/**
+ * @file native.hpp
+ * @author Pagano Florian
+ * @brief The script compiled ahead of time to C++ by snapdesk-codegen, and the helpers of the generated code
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The binary is linked with aot/generated.cpp (make aot) or with aot/stub.cpp, which has no script.
+ *
+ */
+#ifndef NATIVE_HPP
+#define NATIVE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "decoder/frame.hpp"
+#include "digest/hash.hpp"
+
+namespace native{
+    /**
+     * @brief The hash of the script compiled in the binary, as given by Compiler::get_hash(), empty if none
+     *
+     */
+    extern const char SCRIPT_HASH[];
+
+    /**
+     * @brief Compute the fingerprint of a frame with the script compiled in the binary, as bytecode::Vm::run()
+     *
+     * @param frame the decoded frame
+     * @param output the text of the output of the script
+     * @return true if a script is compiled in the binary, false otherwise
+     */
+    bool run(const decoder::Frame *frame, std::string &output);
+
+    /**
+     * @brief Cut bits of a binary value, as Vm::_slice_bit() with the position known at compile time
+     *
+     * @tparam FROM the first bit, from the least significant one
+     * @tparam SIZE the number of bits, not 0
+     * @param destination filled with the (SIZE+7)/8 bytes of the cut
+     * @param number the value to cut
+     * @param number_size the byte length of the value
+     * @return size_t the byte length of the cut, 0 if the cut is out of range
+     */
+    template<size_t FROM, size_t SIZE>
+    inline size_t slice_bit(uint8_t *destination, const uint8_t *number, size_t number_size){
+        static_assert(SIZE > 0, "A cut is not empty");
+
+        constexpr size_t OUTPUT_SIZE = (SIZE + 7) / 8;
+        constexpr size_t SHIFT = FROM % 8;
+        constexpr unsigned LAST_MASK = SIZE % 8 ? (1u << (SIZE % 8)) - 1 : 0xFF;
+
+        if(number_size == 0 || FROM + SIZE > number_size*8)
+            return 0;
+
+        for(size_t i = 0; i < OUTPUT_SIZE; ++i){
+            size_t byte = FROM / 8 + i;
+
+            unsigned value = number[number_size-1-byte] >> SHIFT;
+            if(SHIFT && byte+1 < number_size)
+                value |= number[number_size-2-byte] << (8 - SHIFT);
+
+            if(i == OUTPUT_SIZE-1)
+                value &= LAST_MASK;
+
+            destination[OUTPUT_SIZE-1-i] = (uint8_t) value;
+        }
+
+        return OUTPUT_SIZE;
+    }
+
+    /**
+     * @brief Cut bytes of a binary value, as Vm::_slice_byte() with the position known at compile time
+     *
+     * @tparam FROM the first byte, from the end
+     * @tparam SIZE the number of bytes, not 0
+     * @param data the value to cut
+     * @param size the byte length of the value
+     * @return const uint8_t* the SIZE bytes of the cut in data, nullptr if the cut is out of range
+     */
+    template<size_t FROM, size_t SIZE>
+    inline const uint8_t *slice_byte(const uint8_t *data, size_t size){
+        static_assert(SIZE > 0, "A cut is not empty");
+
+        if(size == 0 || FROM + SIZE > size)
+            return nullptr;
+
+        return data + size - (FROM + SIZE);
+    }
+
+    /**
+     * @brief Append the hex of a binary value to a text
+     *
+     * @tparam UPPER true for uppercase digits
+     * @param output the text
+     * @param data the value
+     * @param size the byte length of the value
+     */
+    template<bool UPPER>
+    inline void append_hex(std::string &output, const uint8_t *data, size_t size){
+        const char *digits = UPPER ? "0123456789ABCDEF" : "0123456789abcdef";
+
+        for(size_t i = 0; i < size; ++i){
+            output.push_back(digits[data[i] >> 4]);
+            output.push_back(digits[data[i] & 0xF]);
+        }
+    }
+
+    /**
+     * @brief Add the hex of a binary value to a hash, by chunks on the stack
+     *
+     * @tparam UPPER true for uppercase digits
+     * @param hash the hash
+     * @param data the value
+     * @param size the byte length of the value
+     */
+    template<bool UPPER>
+    inline void update_hex(digest::Hash &hash, const uint8_t *data, size_t size){
+        const char *digits = UPPER ? "0123456789ABCDEF" : "0123456789abcdef";
+        char chunk[256];
+
+        for(size_t i = 0; i < size; i += sizeof(chunk)/2){
+            size_t count = size - i < sizeof(chunk)/2 ? size - i : sizeof(chunk)/2;
+
+            for(size_t j = 0; j < count; ++j){
+                chunk[2*j] = digits[data[i+j] >> 4];
+                chunk[2*j+1] = digits[data[i+j] & 0xF];
+            }
+            hash.update(chunk, 2*count);
+        }
+    }
+}
+
+#endif
@@ -11,26 +11,57 @@
 #ifndef EXECUTABLE_TREE_HPP
 #define EXECUTABLE_TREE_HPP
 
-#include "decoder/frame.hpp"
+#include "compiler/bytecode.hpp"
+#include "digest/hash.hpp"
 
 #include <vector>
 #include <string>
 
 namespace executable_tree{
     /**
-     * @brief Represents a node of the executable tree
+     * @brief Represents a node of the executable tree, the tree is lowered to a bytecode::Program to be executed
      * @class Node
      * 
      */
     class Node {       
+        protected:
+            size_t _line = 0; ///<The line of the node in the source code, from 1
+
+            /**
+             * @brief Reject the source code because of this node
+             * 
+             * @param message what is wrong
+             */
+            [[noreturn]] void throw_error(const std::string &message) const;
+
         public:
             /**
-             * @brief Get the value of the node
+             * @brief Destroy the Node object
+             * 
+             */
+            virtual ~Node() {};
+
+            /**
+             * @brief Append the instructions computing the value of the node to a program
+             * 
+             * @param program the program being built
+             * @return uint16_t the register holding the value of the node
+             */
+            virtual uint16_t lower(bytecode::Program &program) const;
+            /**
+             * @brief Lower the node, its instructions are given its line for the profile
+             * 
+             * @param program the program being built
+             * @return uint16_t the register holding the value of the node
+             */
+            uint16_t lower_at_line(bytecode::Program &program) const;
+
+            /**
+             * @brief Set the line of the node in the source code, for the error messages
              * 
-             * @param target_frame the frame that is analysed by the executable tree
-             * @return std::string the value returned by the node
+             * @param line the line number, from 1
              */
-            virtual std::string get_value(const decoder::Frame *target_frame) const;
+            void set_line(size_t line);
 
             /**
              * @brief Add a child node to the current node
@@ -38,6 +69,12 @@ namespace executable_tree{
              * @param arg The node to add
              */
             virtual void add_node(Node* arg);
+            /**
+             * @brief Get the lines of the node and of its children, in the order of to_string()
+             * 
+             * @param lines the vector receiving one line per line of to_string()
+             */
+            virtual void get_lines(std::vector<size_t> &lines) const;
 
             /**
              * @brief get the string representing the node
@@ -52,10 +89,14 @@ namespace executable_tree{
      * @brief The node that represent the root of the executable tree, it does not do anything but have one child
      * @class Root
      * 
+     * The child is followed by the Output nodes of the script, the outputs of the tree are the value of the child
+     * then the value of each Output node.
+     * 
      */
     class Root : public Node {
         private:
             Node* _first_node = nullptr; ///<The child that will output the result
+            std::vector<Node*> _outputs; ///<The Output blocks, each one a column next to the result
 
         public:
             /**
@@ -65,11 +106,58 @@ namespace executable_tree{
             ~Root(){
                 if(_first_node)
                     delete _first_node;
+                for(Node* output : _outputs)
+                    delete output;
+            };
+
+            uint16_t lower(bytecode::Program &program) const override;
+
+            void add_node(Node* arg) override;
+            void get_lines(std::vector<size_t> &lines) const override;
+
+            std::string to_string(size_t depth) const override;
+    };
+
+    /**
+     * @brief The node of an "Output <name> {" block, it outputs the value of its child in the column of its name
+     * @class Output
+     * 
+     * The Output blocks follow the result in the root, they are lowered in the same program so the fields
+     * and the cuts they share with the result are computed once.
+     * 
+     */
+    class Output : public Node {
+        private:
+            const std::string _name; ///<The name of the column
+            Node* _value = nullptr; ///<The child giving the value of the column
+
+        public:
+            /**
+             * @brief Construct a new Output object
+             * 
+             * @param name the name of the column
+             */
+            Output(const std::string &name) : _name(name) {};
+            /**
+             * @brief Destroy the Output object
+             * 
+             */
+            ~Output(){
+                if(_value)
+                    delete _value;
             };
 
-            std::string get_value(const decoder::Frame *target_frame) const override;
+            /**
+             * @brief Get the name of the column
+             * 
+             * @return const std::string& the name
+             */
+            const std::string &get_name() const;
+
+            uint16_t lower(bytecode::Program &program) const override;
 
             void add_node(Node* arg) override;
+            void get_lines(std::vector<size_t> &lines) const override;
 
             std::string to_string(size_t depth) const override;
     };
@@ -83,6 +171,52 @@ namespace executable_tree{
         protected:
             std::vector<Node*> args; ///<The vector of arguments of the function
 
+            /**
+             * @brief Lower the arguments, in order, each one fed to a hash as soon as it is computed
+             * 
+             * @param program the program being built
+             * @param algorithm the algorithm of the hash
+             * @param as_text true to hash the text of the arguments, false to hash their bytes
+             * @param key the key of the keyed algorithms, empty for the others
+             * @param first the index of the first argument to hash
+             * @return uint16_t the register holding the digest
+             */
+            uint16_t lower_hash(bytecode::Program &program, digest::Algorithm algorithm, bool as_text, const std::string &key = "", size_t first = 0) const;
+            /**
+             * @brief Reject the function if it has not exactly the given number of arguments
+             * 
+             * @param count the number of arguments
+             * @param name the name of the function
+             */
+            void check_arity(size_t count, const std::string &name) const;
+            /**
+             * @brief Get an argument that must be a constant decimal number
+             * 
+             * @param index the index of the argument
+             * @param max the max value of the number
+             * @param what the name of the argument, for the error messages
+             * @return size_t the number
+             */
+            size_t get_integer(size_t index, size_t max, const std::string &what) const;
+            /**
+             * @brief Get an argument that must be a constant hex number of a given length, as a key
+             * 
+             * @param index the index of the argument
+             * @param length the byte length of the number
+             * @param what the name of the argument, for the error messages
+             * @return std::string the bytes of the number, the most significant first
+             */
+            std::string get_bytes(size_t index, size_t length, const std::string &what) const;
+            /**
+             * @brief Lower an argument that must be binary, a constant is given in hex and converted at compile time
+             * 
+             * @param program the program being built
+             * @param index the index of the argument
+             * @param what the name of the argument, for the error messages
+             * @return uint16_t the register holding the binary value of the argument
+             */
+            uint16_t lower_binary(bytecode::Program &program, size_t index, const std::string &what) const;
+
         public:
             /**
              * @brief Destroy the Function object
@@ -96,6 +230,7 @@ namespace executable_tree{
             }
 
             void add_node(Node* arg) override;
+            void get_lines(std::vector<size_t> &lines) const override;
 
             std::string to_string(size_t depth) const override;
     };
@@ -117,7 +252,14 @@ namespace executable_tree{
              */
             Value(std::string value) : value(value) {};
 
-            std::string get_value(const decoder::Frame *target_frame) const override;
+            /**
+             * @brief Get the fixed value of the Node
+             * 
+             * @return const std::string& the value, as written in the source code
+             */
+            const std::string &get_constant() const;
+
+            uint16_t lower(bytecode::Program &program) const override;
 
             void add_node(Node* arg) override;
 
@@ -142,7 +284,7 @@ namespace executable_tree{
             Getter(const std::string field_name) 
                 : field_name(field_name){};
 
-            std::string get_value(const decoder::Frame *target_frame) const override;
+            uint16_t lower(bytecode::Program &program) const override;
 
             void add_node(Node* arg) override;
 
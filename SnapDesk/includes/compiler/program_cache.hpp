@@ -0,0 +1,80 @@
+/**
+ * @file program_cache.hpp
+ * @author Pagano Florian
+ * @brief The program of the scripts saved next to them, loaded at the next start instead of compiling them again
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef PROGRAM_CACHE_HPP
+#define PROGRAM_CACHE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "compiler/bytecode.hpp"
+#include "digest/xxh64.hpp"
+
+#define PROGRAM_CACHE_MAGIC "SNAPPRG" ///<The magic at the beginning of a program cache file
+#define PROGRAM_CACHE_EXTENTION ".cache" ///<The extention added to the path of the first script
+#define PROGRAM_CACHE_VERSION 2 ///<The version of the file, to increase when Program::serialize() or the lowering changes
+#define PROGRAM_CACHE_HASH_LENGTH 64 ///<The length of the hash of a script, as given by Compiler::get_hash()
+
+namespace bytecode{
+    /**
+     * @brief The header of a program cache file, followed by the hash of each script then by the program
+     * @struct Program_cache_header
+     *
+     */
+    struct Program_cache_header {
+        char magic[8]; ///<PROGRAM_CACHE_MAGIC
+        uint32_t version; ///<PROGRAM_CACHE_VERSION
+        uint32_t script_count; ///<The number of scripts of the program
+        uint64_t program_size; ///<The number of bytes of the program, as given by Program::serialize()
+        uint64_t program_checksum; ///<The XXH64 of the bytes of the program
+    };
+
+    /**
+     * @brief The program of the scripts saved in a file, keyed by the hashes of the scripts
+     * @class Program_cache
+     *
+     * The file is mapped in memory and its program is used only if the scripts have the same hashes,
+     * in the same order, so a script changed or a file of another version is compiled again. The checksum
+     * of the program rejects a damaged file before its fingerprints are wrong.
+     *
+     */
+    class Program_cache {
+        public:
+            /**
+             * @brief Load the program of the scripts from a cache file
+             *
+             * @param file_name the path of the cache file
+             * @param hashes the hash of each script, as given by Compiler::get_hash()
+             * @return Program* the program, or nullptr if the file is missing, damaged or for other scripts
+             */
+            static Program *load(const std::string &file_name, const std::vector<std::string> &hashes);
+            /**
+             * @brief Save the program of the scripts in a cache file, replaced at once so it is never read half written
+             *
+             * @param file_name the path of the cache file
+             * @param hashes the hash of each script, as given by Compiler::get_hash()
+             * @param program the program of the scripts
+             * @return true if the file is written, false if it cannot be (as in a read-only folder)
+             */
+            static bool store(const std::string &file_name, const std::vector<std::string> &hashes, const Program *program);
+    };
+}
+
+#endif
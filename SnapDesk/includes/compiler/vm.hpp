@@ -0,0 +1,202 @@
+/**
+ * @file vm.hpp
+ * @author Pagano Florian
+ * @brief The register machine executing the bytecode programs
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef VM_HPP
+#define VM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "compiler/bytecode.hpp"
+#include "digest/hash.hpp"
+#include "digest/sha256_multi.hpp"
+#include "decoder/frame.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILE_TICK_UNIT "cycles" ///<The unit of the ticks of the profile, the time stamp counter
+#else
+#include <ctime>
+#define PROFILE_TICK_UNIT "ns" ///<The unit of the ticks of the profile, the monotonic clock
+#endif
+
+namespace bytecode{
+    /**
+     * @brief A value held by the Vm, the bytes are kept binary and only written as text for the output
+     *
+     */
+    struct Register {
+        const uint8_t *data; ///<The bytes of the value, in the frame, in a constant or in storage
+        size_t size; ///<The number of bytes
+        size_t bit_length; ///<The number of significant bits, the bytes are right aligned
+        Encoding encoding; ///<How the value is written as text
+        std::vector<uint8_t> storage; ///<The bytes computed by the Vm, allocated once
+    };
+
+    /**
+     * @brief What the execution of an instruction cost, summed over the runs
+     *
+     */
+    struct Instruction_profile {
+        size_t count = 0; ///<The number of executions
+        uint64_t ticks = 0; ///<The time spent, in PROFILE_TICK_UNIT
+        size_t bytes = 0; ///<The bytes written in the destination, or given to the hash
+    };
+
+    /**
+     * @brief Execute a Program on decoded frames
+     * @class Vm
+     *
+     * The registers, the scratch buffers and the hash contexts are allocated once,
+     * so running a program does not allocate once the buffers reached their final size.
+     *
+     */
+    class Vm {
+        private:
+            const Program *_program; ///<The executed program
+            std::vector<Register> _registers; ///<The registers
+            std::vector<std::string> _outputs; ///<The text of the outputs of the program
+            std::vector<const Register *> _emitted; ///<The register of each output, during a run
+            std::vector<digest::Hash *> _hashes; ///<The reused hash of each hash slot
+            bool _is_profiling = false; ///<true to record the profile of each instruction
+            std::vector<Instruction_profile> _profile; ///<The profile of each instruction
+            size_t _batch_capacity = 0; ///<The number of frames the batch registers and hashes are allocated for
+            std::vector<Register> _batch_registers; ///<The registers of run_batch(), the column of the register r starts at r * _batch_capacity
+            std::vector<digest::Hash *> _batch_hashes; ///<The hashes of run_batch(), the column of the slot h starts at h * _batch_capacity
+            bool _is_sha256_multi = digest::Sha256_multi::is_preferred(); ///<true to hash the SHA-256 slots of run_batch() with Sha256_multi
+            std::vector<std::string> _batch_messages; ///<The messages of the SHA-256 slots of run_batch(), laid out as _batch_hashes
+            std::vector<const uint8_t *> _batch_message_data; ///<The start of each message given to Sha256_multi
+            std::vector<size_t> _batch_message_sizes; ///<The size of each message given to Sha256_multi
+            std::vector<uint8_t> _batch_digests; ///<The digests computed by Sha256_multi, one after the other
+
+            /**
+             * @brief Read the clock of the profile
+             *
+             * @return uint64_t the ticks, in PROFILE_TICK_UNIT
+             */
+            static uint64_t _read_ticks();
+            /**
+             * @brief Execute the instructions of the program
+             *
+             * Without profiling, nothing is measured, the profile is not in the compiled loop.
+             *
+             * @param target_frame the decoded frame
+             */
+            template<bool PROFILE>
+            void _execute(const decoder::Frame *target_frame);
+
+            /**
+             * @brief Append the text of a value to a buffer, as the tree used to give it
+             *
+             * @param output the buffer
+             * @param value the value
+             */
+            template<typename Buffer>
+            static void _append_text(Buffer &output, const Register &value);
+            /**
+             * @brief Cut bits of a binary value, as Big_number::cut_bit()
+             *
+             * @param destination the register receiving the bits, null if the cut is out of range
+             * @param source the value to cut
+             * @param from the first bit, from the least significant one
+             * @param size the number of bits, not 0
+             */
+            static void _slice_bit(Register &destination, const Register &source, size_t from, size_t size);
+            /**
+             * @brief Cut bytes of a binary value, as Big_number::cut_byte()
+             *
+             * @param destination the register receiving the bytes, null if the cut is out of range
+             * @param source the value to cut
+             * @param from the first byte, from the end
+             * @param size the number of bytes, not 0
+             */
+            static void _slice_byte(Register &destination, const Register &source, size_t from, size_t size);
+            /**
+             * @brief Add the text of a value to a hash, the hex is written by chunks on the stack
+             *
+             * @param hash the hash
+             * @param value the value
+             */
+            static void _update_text(digest::Hash &hash, const Register &value);
+            /**
+             * @brief Allocate the registers and the hashes of run_batch() for a number of frames, if they are not yet
+             *
+             * @param count the number of frames of the batch
+             */
+            void _reserve_batch(size_t count);
+
+        public:
+            /**
+             * @brief Construct a new Vm object and allocate the registers of a program
+             *
+             * @param program the program to execute, it must outlive the Vm
+             */
+            Vm(const Program *program);
+            /**
+             * @brief Destroy the Vm object
+             *
+             */
+            ~Vm();
+
+            /**
+             * @brief Run the program on a frame
+             *
+             * @param target_frame the decoded frame
+             * @return const std::string& the text of the first output of the program, valid until the next run
+             */
+            const std::string &run(const decoder::Frame *target_frame);
+            /**
+             * @brief Get the outputs of the last run
+             *
+             * @return const std::vector<std::string>& the text of each output, one per script
+             */
+            const std::vector<std::string> &get_outputs() const;
+            /**
+             * @brief Run the program on a batch of frames, in column order
+             *
+             * Each instruction runs on every frame before the next one, so its code and its operands stay hot
+             * and the loop of each operation is the same for the whole batch. The outputs are the ones of run(),
+             * the profile is not recorded.
+             *
+             * @param frames the decoded frames
+             * @param count the number of frames
+             * @param outputs the array of count * Program::get_output_count() strings receiving the outputs, the output j
+             * of the frame i in outputs[i * Program::get_output_count() + j], their buffers are reused from one batch to the next
+             */
+            void run_batch(const decoder::Frame *const *frames, size_t count, std::string *outputs);
+            /**
+             * @brief Choose how run_batch() computes the SHA-256 hashes, the digests are the same
+             *
+             * By default Sha256_multi is used when it is faster than OpenSSL, see Sha256_multi::is_preferred(),
+             * and only for the batches filling all its lanes.
+             *
+             * @param is_sha256_multi true to hash the messages of the batch together with Sha256_multi, false for OpenSSL
+             */
+            void set_sha256_multi(bool is_sha256_multi);
+            /**
+             * @brief Start or stop recording the profile of each instruction, the profile is kept
+             *
+             * @param is_profiling true to record the profile
+             */
+            void set_profiling(bool is_profiling);
+            /**
+             * @brief Get the profile recorded
+             *
+             * @return const std::vector<Instruction_profile>& the profile of each instruction of the program
+             */
+            const std::vector<Instruction_profile> &get_profile() const;
+    };
+}
+
+#endif
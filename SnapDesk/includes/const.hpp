@@ -22,5 +22,6 @@
 #define FRAME_MAX_LENGTH BEACON_FRAME_MAX_LENGTH ///<The max length of a frame 
 
 #define DATABASE_ROOT "database" ///<The root directory name where logs will be saved
+#define DATABASE_LEGACY_FOLDER "snappy_txt" ///<The folder of every database written before each script had its own
 
 #endif
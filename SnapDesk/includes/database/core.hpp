@@ -14,10 +14,12 @@
 #include <string>
 #include <vector>
 #include <algorithm>
-
-#include <openssl/evp.h>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
 
 #include "os_communicator/os_communicator.hpp"
+#include "digest/sha256.hpp"
 #include "const.hpp"
 
 // Number of line that are not raw data
@@ -25,8 +27,12 @@
 #define DELIMITER ";"
 #define DATA_EXTENTION ".csv"
 #define METADATA_EXTENTION ".metadata"
+#define LOG_EXTENTION ".log"
+#define COMPACTING_LOG_EXTENTION ".log.old"
+#define LOG_COMPACTION_RECORDS 1024 ///<The number of records of the log from which the csv file is rewritten
 #define KEY_LINE_NUMBER 0
 #define COLUMN_NUMBER_LINE_NUMBER 1
+#define OUTPUT_COLUMNS_LINE_NUMBER 2
 #define COLUMN_NAMES {"output", "creation_date", "last_date"}
 #define KEY_COLUMN_NUMBER 0
 
@@ -35,13 +41,91 @@ namespace database{
      * @brief This class represent and operates a csv file
      * @class Csv
      * 
+     * The file is read once when it is opened: its rows stay in memory with the row of each key,
+     * and the reads never go back to the file.
+     * 
+     * A write appends one record, the number and the new line of its row, to the log next to the csv file.
+     * The csv file is rewritten from the memory in a background thread when the log has LOG_COMPACTION_RECORDS
+     * records, the log being renamed with COMPACTING_LOG_EXTENTION until then. Opening the file replays the logs
+     * on its rows, and finishes a compaction that did not end or compacts a log cut by a crash. A record gives a whole row, so replaying it twice is harmless.
+     * 
      */
     class Csv{
         private:
             size_t _number_of_columns; ///<The number of columns in the file
             size_t _key_column_number; ///<The column number of the key column
+            std::vector<std::string> _output_column_names; ///<The names of the columns written by the Output blocks of the script, next to the key
             os_communicator::Communicator *_c_metadata; ///<The Communicator instance to the metadata file
             os_communicator::Communicator *_c_data; ///<The Communicator instance to the csv file
+            std::string _header; ///<The first line of the csv file, the names of the columns
+            std::vector<std::string> _rows; ///<The line of each row, as in the csv file
+            std::unordered_map<std::string, size_t> _key_positions; ///<The row number of each key value
+            std::string _file_name; ///<The name of the storage file (without extentions)
+            os_communicator::Communicator *_c_log = nullptr; ///<The Communicator instance to the log of the writes
+            size_t _log_records = 0; ///<The number of records in the log
+            std::thread _compaction; ///<The last thread rewriting the csv file, joined before the next one and by the destructor
+            std::atomic<bool> _is_compacting{false}; ///<true while the compaction thread runs
+
+            /**
+             * @brief Read the csv file once, and index its rows by key
+             * 
+             * The rows end at the first empty line, a key written twice gives its first row.
+             */
+            void _load();
+            /**
+             * @brief Tell if a row can be written as a record and read back from the log
+             * 
+             * @param row_number the number of the row, the number of rows for a new row
+             * @param line the line of the row
+             * @return true if the row number exists or is the next one, and the line has one cell per column on one line
+             */
+            bool _is_valid_record(size_t row_number, const std::string &line) const;
+            /**
+             * @brief Write a row in memory
+             * 
+             * @param row_number the number of the row, the number of rows for a new row
+             * @param line the line of the row
+             * @return true if the row is written, false if the row number or the number of cells is wrong
+             */
+            bool _apply_record(size_t row_number, const std::string &line);
+            /**
+             * @brief Write the records of a log in memory, in their order
+             * 
+             * A record cut by a crash, without its end of line, and the wrong records are ignored.
+             * 
+             * @param log the log
+             * @param is_damaged set to true if a record is ignored, left unchanged otherwise
+             * @return size_t the number of records written
+             */
+            size_t _replay(os_communicator::Communicator &log, bool &is_damaged);
+            /**
+             * @brief Write a row to the log and in memory, and start the compaction if the log is long enough
+             * 
+             * @param row_number the number of the row, the number of rows for a new row
+             * @param line the line of the row
+             */
+            void _append_record(size_t row_number, const std::string &line);
+            /**
+             * @brief Get the content of the csv file with every record written
+             * 
+             * @return std::string the header and the rows, one per line
+             */
+            std::string _get_content() const;
+            /**
+             * @brief Start the compaction in the background if the log has LOG_COMPACTION_RECORDS records and none is running
+             * 
+             */
+            void _compact();
+            /**
+             * @brief Rewrite a csv file and delete the log it contains, the body of the compaction thread
+             * 
+             * On failure, the log stays and the next opening of the file finishes the compaction.
+             * 
+             * @param file_name the name of the storage file (without extentions)
+             * @param content the new content of the csv file
+             * @param is_compacting set to false at the end
+             */
+            static void _rewrite(std::string file_name, std::string content, std::atomic<bool> *is_compacting);
 
             /**
              * @brief Throw an error if the given values vector is not at the right size
@@ -50,10 +134,10 @@ namespace database{
              */
             void _test_values_size(std::vector<std::string> values);
             /**
-             * @brief Get the line number of a value corresponding to a key
+             * @brief Get the row number of a value corresponding to a key, from the index
              * 
              * @param key_value the value to look for
-             * @return size_t the line number of the targeted key or -1 if not found
+             * @return size_t the row number of the targeted key or -1 if not found
              */
             size_t _get_key_position(std::string key_value);
             /**
@@ -63,6 +147,13 @@ namespace database{
              * @return std::string the values in form of line
              */
             static std::string _values_to_line(std::vector<std::string> values);
+            /**
+             * @brief Tranform a single string line into a vector of values
+             * 
+             * @param line the values in form of line
+             * @return std::vector<std::string> the values in form of vector
+             */
+            static std::vector<std::string> _line_to_values(std::string line);
             /**
              * @brief Give the position of the targeted column name from the csv header
              * 
@@ -95,19 +186,22 @@ namespace database{
              */
             Csv(std::string file_name);
             /**
-             * @brief Destroy the Csv object
+             * @brief Destroy the Csv object, after the end of its compaction
              * 
              */
             ~Csv();
             /**
              * @brief Construct a new Csv object on a file that does not exist
              * 
+             * The output columns are inserted right after the key column and recorded in the metadata.
+             * 
              * @param file_name the filename of the new storage file (without extentions)
              * @param column_names the names of the columns
              * @param key_column_number the column number of the key
+             * @param output_column_names the names of the columns written by the Output blocks of the script
              * @return Csv* the new Csv instance of the new storage file
              */
-            static Csv *create(std::string file_name, std::vector<std::string> column_names, size_t key_column_number);
+            static Csv *create(std::string file_name, std::vector<std::string> column_names, size_t key_column_number, std::vector<std::string> output_column_names = {});
 
             /**
              * @brief Create a new entry in the file
@@ -153,11 +247,19 @@ namespace database{
             /**
              * @brief Get all key values that has a value on a given column
              * 
+             * On the key column, the key is found in the index without looking at every row.
+             * 
              * @param column_number the number of the column to look for matches
              * @param value the value to compare
              * @return std::vector<std::string> a vector containing all the key values 
              */
             std::vector<std::string> get_all_keys_with_value(size_t column_number, std::string value);
+            /**
+             * @brief Get the names of the columns written by the Output blocks of the script
+             * 
+             * @return const std::vector<std::string>& the names, from the metadata, empty for a file created without them
+             */
+            const std::vector<std::string> &get_output_column_names() const;
     };
 
     /**
@@ -172,20 +274,41 @@ namespace database{
             std::string _code_hash; ///<The hash of the content of the given code
             Csv *_csv; ///<The Csv instance to manipulate the storage file
 
+            /**
+             * @brief Get the folder of the databases of a code, without its hash
+             * 
+             * @param code_file_name The file name of the code
+             * @return std::string the folder name
+             */
+            static std::string _get_folder_name(std::string code_file_name);
+
         public:
             /**
              * @brief Construct a new Database object
              * 
+             * The code is not read again, its hash is the one of the compiled code.
+             * 
              * @param ssid The SSID of the analysed frames
              * @param code_file_name The file name of the used code
+             * @param code_hash The hash of the code, as given by compiler::Compiler::get_hash()
+             * @param output_names The names of the Output blocks of the code, as given by compiler::Compiler::get_output_names()
              */
-            Database(std::string ssid, std::string code_file_name);
+            Database(std::string ssid, std::string code_file_name, std::string code_hash, std::vector<std::string> output_names = {});
             /**
              * @brief Destroy the Database object
              * 
              */
             ~Database();
 
+            /**
+             * @brief Move the databases written before each script had its own folder to the folder of a code
+             * 
+             * Nothing is moved if the code already has a folder, or if there is no such database.
+             * 
+             * @param code_file_name The file name of the code
+             */
+            static void adopt_legacy_folder(std::string code_file_name);
+
             /**
              * @brief Get a cell given the value of its key and its column number
              * 
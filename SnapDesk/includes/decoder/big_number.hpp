@@ -88,6 +88,18 @@ namespace decoder{
              * @return Big_number the clone of the object
              */
             Big_number copy() const;
+            /**
+             * @brief Get the bytes of the number, most significant first
+             * 
+             * @return const uint8_t* the first byte, valid until the number is modified
+             */
+            const uint8_t *data() const;
+            /**
+             * @brief Get the byte length of the number
+             * 
+             * @return size_t the number of bytes
+             */
+            size_t size() const;
 
             /* Operators */
 
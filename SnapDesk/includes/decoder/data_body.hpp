@@ -0,0 +1,63 @@
+/**
+ * @file data_body.hpp
+ * @author Pagano Florian
+ * @brief 
+ * @version 0.1
+ * @date 2025
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#ifndef DATA_BODY_HPP
+#define DATA_BODY_HPP
+
+#include <cstdint>
+#include <const.hpp>
+#include <string>
+#include "decoder/frame.hpp"
+#include "decoder/big_number.hpp"
+
+using namespace std;
+
+namespace decoder{
+    /**
+     * @brief Is the body of a data frame, the payload is kept as is (it may be encrypted)
+     * @class Data_body
+     * 
+     */
+    class Data_body : public Body {
+        private:
+            Big_number _payload; ///<The payload of the frame
+
+            /**
+             * @brief decode the body and fill the fields
+             * 
+             */
+            void decode() override;
+
+        public:
+            /**
+             * @brief Construct a new Data_body object
+             * 
+             * @param raw_body_buffer a buffer containing the exact data body
+             * @param raw_buffer_size the size of the buffer
+             */
+            Data_body(uint8_t *raw_body_buffer, size_t raw_buffer_size);
+
+            /**
+             * @brief Print the content of the data body
+             * 
+             */
+            void print() const override;
+            /**
+             * @brief Get the value of a specific field
+             * 
+             * @param field the name of the field ("payload")
+             * @return Big_number the value, or null if this do not exist
+             */
+            Big_number get_value(string field) const override;
+            bool get_field(const Field &field, Span &span) const override;
+    };
+}
+
+#endif
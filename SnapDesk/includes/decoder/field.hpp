@@ -0,0 +1,85 @@
+/**
+ * @file field.hpp
+ * @author Pagano Florian
+ * @brief Resolved names of the fields of a frame, to read them without comparing strings
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef FIELD_HPP
+#define FIELD_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace decoder{
+    /**
+     * @brief Where the value of a field is found
+     *
+     */
+    enum Field_kind {
+        FIELD_NONE, ///<The field never exists
+        FIELD_HEADER, ///<A field of the MAC header, the id is a Header_field
+        FIELD_BODY, ///<A named field of the body, the id is a Body_field
+        FIELD_SUB_FIELD, ///<A sub-field of a known IE, the id is a Sub_field_id
+        FIELD_IE ///<The content of an IE, the id is the element id
+    };
+
+    /**
+     * @brief The fields of the MAC header
+     *
+     */
+    enum Header_field {
+        HEADER_FRAME_CONTROL,
+        HEADER_DURATION,
+        HEADER_DESTINATION_ADDRESS,
+        HEADER_SOURCE_ADDRESS,
+        HEADER_BSSID,
+        HEADER_RECEIVER_ADDRESS,
+        HEADER_TRANSMITTER_ADDRESS,
+        HEADER_ADDRESS_4,
+        HEADER_SEQUENCE_CONTROL,
+        HEADER_QOS_CONTROL,
+        HEADER_HT_CONTROL,
+        HEADER_FRAME_CHECK_SUM,
+
+        HEADER_FIELD_COUNT
+    };
+
+    /**
+     * @brief The named fields of the bodies
+     *
+     */
+    enum Body_field {
+        BODY_TIMESTAMP, ///<beacon body
+        BODY_BEACON_INTERVAL, ///<beacon body
+        BODY_CAPABILITIES_INFORMATION, ///<beacon body
+        BODY_PAYLOAD, ///<data body
+        BODY_IE_ORDER, ///<beacon body, the element ids of the IEs in their order
+        BODY_IE_SET, ///<beacon body, the set of the element ids of the IEs
+
+        BODY_FIELD_COUNT
+    };
+
+    /**
+     * @brief A field name resolved once, given by Frame::resolve_field()
+     *
+     */
+    struct Field {
+        Field_kind kind; ///<Where the value is found
+        size_t id; ///<The id of the field, depending on the kind
+    };
+
+    /**
+     * @brief A view on the value of a field, big endian, valid until the frame is decoded again
+     *
+     */
+    struct Span {
+        const uint8_t *data; ///<The first byte of the value
+        size_t size; ///<The byte length of the value
+    };
+}
+
+#endif
@@ -15,9 +15,13 @@
 #include <const.hpp>
 #include <string>
 #include <vector>
+#include <algorithm>
 
 #include "os_communicator/os_communicator.hpp"
 #include "decoder/big_number.hpp"
+#include "decoder/field.hpp"
+#include "decoder/header_layout.hpp"
+#include "decoder/validator.hpp"
 
 using namespace std;
 
@@ -45,6 +49,11 @@ namespace decoder{
              * @param raw_buffer_size the size of the buffer
              */
             Body(uint8_t *raw_body_buffer, size_t raw_buffer_size);
+            /**
+             * @brief Destroy the Body object
+             * 
+             */
+            virtual ~Body() {};
             
             /**
              * @brief Print the content of the body
@@ -58,6 +67,14 @@ namespace decoder{
              * @return Big_number the value or null if not found
              */
             virtual Big_number get_value(string field) const = 0;
+            /**
+             * @brief Get a view on the value of a resolved field, without copying it
+             * 
+             * @param field the field given by Frame::resolve_field()
+             * @param span filled with the value if the field is found
+             * @return true if the field is found
+             */
+            virtual bool get_field(const Field &field, Span &span) const = 0;
 
             /**
              * @brief Give the Body objects corresponding to the type and subtype
@@ -79,12 +96,22 @@ namespace decoder{
     class Frame{
         private:
             os_communicator::Communicator *communicator; ///<the Communicator to the character device giving the frames
+
+            /**
+             * @brief Initialise the members shared by the constructors
+             * 
+             * @param _communicator Communicator on the character device, or nullptr for a frame fed with set_raw_data()
+             */
+            void init(os_communicator::Communicator *_communicator);
         protected:
             uint8_t *raw_frame_buffer; ///<the buffer containing the frame that is not decoded
             size_t raw_buffer_size; ///<the size of the buffer
             size_t raw_frame_size; ///<the size of the frame in the buffer
             bool is_decoded; ///< true if the buffer is decoded, false if not
             bool has_raw_data; ///< true if raw_frame_buffer is filled
+            bool is_validated; ///< true if the raw data has been accepted or truncated by a Validator
+            size_t valid_body_length; ///< the length of the body to decode, given by the Validator
+            Validation_reason validation_reason; ///< the reason of the last verdict of the Validator
 
             // Header
             Big_number frame_control = Big_number::null();
@@ -92,12 +119,41 @@ namespace decoder{
             Big_number destination_address = Big_number::null();
             Big_number source_address = Big_number::null();
             Big_number bssid = Big_number::null();
+            Big_number receiver_address = Big_number::null();
+            Big_number transmitter_address = Big_number::null();
+            Big_number address_4 = Big_number::null();
             Big_number sequence_control = Big_number::null();
+            Big_number qos_control = Big_number::null();
+            Big_number ht_control = Big_number::null();
             Big_number frame_check_sum = Big_number::null();
 
             // Body
             Body *body = nullptr; ///<the body of the frame
 
+            /**
+             * @brief Read a field of the header at a fixed offset
+             * 
+             * @tparam OFFSET the offset of the field in the header, or NO_FIELD
+             * @tparam SIZE the byte size of the field
+             * @return Big_number the value of the field, or null if the field is not in the header
+             */
+            template<uint8_t OFFSET, size_t SIZE>
+            Big_number get_header_field() const;
+            /**
+             * @brief Decode the MAC header, every offset is known at compile time
+             * 
+             * @tparam LAYOUT the index of the layout of the header in HEADER_LAYOUTS
+             */
+            template<size_t LAYOUT>
+            void decode_header();
+            /**
+             * @brief Build the table of the header decoders, one for each layout
+             * 
+             * @return std::array<void (Frame::*)(), sizeof...(I)> the decoders, indexed by layout index
+             */
+            template<size_t... I>
+            static constexpr std::array<void (Frame::*)(), sizeof...(I)> get_header_decoders(std::index_sequence<I...>);
+
         public:
             /**
              * @brief Construct a new Frame object
@@ -105,6 +161,11 @@ namespace decoder{
              * @param _communicator Communicator on the character device
              */
             Frame(os_communicator::Communicator *_communicator);
+            /**
+             * @brief Construct a new Frame object without character device, it is fed with set_raw_data()
+             * 
+             */
+            Frame();
             /**
              * @brief Destroy the Frame object
              * 
@@ -123,11 +184,38 @@ namespace decoder{
              * 
              */
             void update_raw_data();
+            /**
+             * @brief Copy a frame given by the caller into raw_frame_buffer, as update_raw_data() would do
+             * 
+             * @param buffer the buffer containing the frame, FCS included
+             * @param size the size of the frame
+             */
+            void set_raw_data(const uint8_t *buffer, size_t size);
+            /**
+             * @brief Get the raw frame
+             * 
+             * @param size filled with the size of the raw frame
+             * @return const uint8_t* the raw frame, or nullptr if there is no raw data
+             */
+            const uint8_t *get_raw_data(size_t &size) const;
             /**
              * @brief Print the raw_frame_buffer as hex bytes
              * 
              */
             void print_raw_data();
+            /**
+             * @brief Check the raw_frame_buffer before decoding it, a truncated frame will be decoded up to its last consistent IE
+             * 
+             * @param validator the Validator counting the outcomes
+             * @return Verdict VERDICT_DROP if the frame must not be decoded
+             */
+            Verdict validate(Validator &validator);
+            /**
+             * @brief Get the reason of the verdict given by the last call to validate()
+             * 
+             * @return Validation_reason the reason
+             */
+            Validation_reason get_validation_reason() const;
             /**
              * @brief Decode the raw_frame_buffer to fill the different fields
              * 
@@ -145,6 +233,54 @@ namespace decoder{
              * @return Big_number the field value, or null if not found
              */
             Big_number get_value(string field) const;
+            /**
+             * @brief Get a view on the value of a resolved field, without copying it nor comparing names
+             * 
+             * @param field the field given by resolve_field()
+             * @param span filled with the value if the field is found
+             * @return true if the field is found, false if it is null
+             */
+            bool get_field(const Field &field, Span &span) const;
+            /**
+             * @brief Find a field in the raw frame, before decode(), without copying it
+             * 
+             * Only the header, the fixed fields of a beacon and the IEs are found. The header and the fixed fields
+             * are little endian in the raw frame, their bytes are in the reverse order of get_field().
+             * 
+             * @param field the field given by resolve_field()
+             * @param span filled with the bytes of the field in the raw frame if the field is found
+             * @return true if the field is found, false if it is null or if it cannot be found before decode()
+             */
+            bool peek_field(const Field &field, Span &span) const;
+
+            /**
+             * @brief Resolve a field name once, with the same rules as get_value()
+             * 
+             * @param field the name of the field
+             * @return Field the resolved field, of kind FIELD_NONE if no frame can have it
+             */
+            static Field resolve_field(const string &field);
+            /**
+             * @brief Get the byte length of a field when it is not null, if it is fixed
+             * 
+             * @param field the field given by resolve_field()
+             * @return size_t the byte length, or SIZE_MAX if it depends on the frame
+             */
+            static size_t get_field_width(const Field &field);
+            /**
+             * @brief Tell if a field can be found by peek_field()
+             * 
+             * @param field the field given by resolve_field()
+             * @return true if peek_field() finds the field when it is in the frame
+             */
+            static bool is_peekable(const Field &field);
+            /**
+             * @brief Tell if the bytes of a field found by peek_field() are in the reverse order of get_field()
+             * 
+             * @param field the field given by resolve_field()
+             * @return true for the header and the fixed fields of the body
+             */
+            static bool is_peek_reversed(const Field &field);
     };
 }
 
@@ -0,0 +1,103 @@
+/**
+ * @file frame_batch.hpp
+ * @author Pagano Florian
+ * @brief Decode bursts of frames into columns
+ * @version 0.1
+ * @date 2025
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#ifndef FRAME_BATCH_HPP
+#define FRAME_BATCH_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <const.hpp>
+
+#include "decoder/header_layout.hpp"
+
+using namespace std;
+
+namespace decoder{
+    /**
+     * @brief A batch of decoded frames stored as structure of arrays, frame i is the row i of every column
+     * @class Frame_batch
+     * 
+     * Only the header and the IE positions are decoded, the bodies stay in the buffers of the caller,
+     * that must outlive the batch.
+     * 
+     */
+    class Frame_batch {
+        private:
+            size_t _size = 0; ///<The number of frames in the batch
+            vector<uint8_t> _is_valid; ///<1 if the frame has been decoded, 0 if it is too short or not supported
+            vector<uint16_t> _frame_control; ///<The frame control of each frame
+            vector<uint64_t> _bssid; ///<The BSSID of each frame, first byte in the lowest bits, 0 if none
+            vector<uint16_t> _sequence_control; ///<The sequence control of each frame
+            vector<const uint8_t *> _body; ///<The start of the body of each frame
+            vector<uint16_t> _body_length; ///<The length of the body of each frame (FCS excluded)
+            vector<uint32_t> _ie_begin; ///<The index of the first IE of each frame in the IE columns, size()+1 entries
+            vector<uint8_t> _ie_id; ///<The element id of each IE
+            vector<uint16_t> _ie_offset; ///<The offset of the content of each IE in the body of its frame
+            vector<uint8_t> _ie_length; ///<The length of the content of each IE
+
+            /**
+             * @brief Add the IEs of a beacon body to the IE columns
+             * 
+             * @param body the body of the beacon
+             * @param body_length the length of the body
+             */
+            void _index_ies(const uint8_t *body, size_t body_length);
+
+        public:
+            /**
+             * @brief Construct a new Frame_batch object
+             * 
+             * @param capacity the number of frames that is expected in a batch, columns are allocated for it
+             */
+            Frame_batch(size_t capacity);
+
+            /**
+             * @brief Decode a burst of raw frames, the previous content of the batch is forgotten
+             * 
+             * @param frames the start of each raw frame (FCS included)
+             * @param sizes the size of each raw frame
+             * @param count the number of frames
+             */
+            void decode(const uint8_t *const *frames, const size_t *sizes, size_t count);
+
+            /**
+             * @brief Get the number of frames of the batch
+             * 
+             * @return size_t the number of frames
+             */
+            size_t size() const;
+            /**
+             * @brief Find an IE in a frame of the batch
+             * 
+             * @param frame the row of the frame
+             * @param element_id the element id to look for
+             * @return size_t the index of the first IE with this id in the IE columns, or -1 if not found
+             */
+            size_t find_ie(size_t frame, uint8_t element_id) const;
+
+            /* Columns */
+
+            const uint8_t *get_is_valid() const { return _is_valid.data(); }; ///<size() validity flags
+            const uint16_t *get_frame_control() const { return _frame_control.data(); }; ///<size() frame controls
+            const uint64_t *get_bssid() const { return _bssid.data(); }; ///<size() BSSIDs
+            const uint16_t *get_sequence_control() const { return _sequence_control.data(); }; ///<size() sequence controls
+            const uint8_t *const *get_body() const { return _body.data(); }; ///<size() body starts
+            const uint16_t *get_body_length() const { return _body_length.data(); }; ///<size() body lengths
+            const uint32_t *get_ie_begin() const { return _ie_begin.data(); }; ///<size()+1 indexes in the IE columns
+            const uint8_t *get_ie_id() const { return _ie_id.data(); }; ///<The element id of each IE
+            const uint16_t *get_ie_offset() const { return _ie_offset.data(); }; ///<The offset in its body of each IE content
+            const uint8_t *get_ie_length() const { return _ie_length.data(); }; ///<The length of each IE content
+    };
+}
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file header_layout.hpp
+ * @author Pagano Florian
+ * @brief Compile time description of the MAC header layouts of the different kinds of frame
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef HEADER_LAYOUT_HPP
+#define HEADER_LAYOUT_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <utility>
+
+#include "const.hpp"
+
+#define NO_FIELD 0xFF ///<The offset of a field that is not in the header
+
+#define TYPE_MANAGEMENT 0 ///<The type of the management frames
+#define TYPE_CONTROL 1 ///<The type of the control frames
+#define TYPE_DATA 2 ///<The type of the data frames
+#define TYPE_EXTENSION 3 ///<The type of the extension frames
+
+#define HEADER_LAYOUT_COUNT 64 ///<The number of possible layouts (type, ToDS, FromDS, QoS, Order)
+
+namespace decoder{
+    /**
+     * @brief Give the offset of each field of a MAC header, or NO_FIELD if the field is not present
+     *
+     * The length is 0 for the frames that are not supported.
+     *
+     */
+    struct Header_layout {
+        uint8_t length; ///<The length of the header
+        uint8_t destination_address; ///<The offset of the destination address
+        uint8_t source_address; ///<The offset of the source address
+        uint8_t bssid; ///<The offset of the BSSID
+        uint8_t receiver_address; ///<The offset of the receiver address
+        uint8_t transmitter_address; ///<The offset of the transmitter address
+        uint8_t address_4; ///<The offset of the fourth address
+        uint8_t sequence_control; ///<The offset of the sequence control
+        uint8_t qos_control; ///<The offset of the QoS control
+        uint8_t ht_control; ///<The offset of the HT control
+    };
+
+    /**
+     * @brief Get the layout index of a frame given its frame control
+     *
+     * @param frame_control the frame control, as read little endian from the frame
+     * @return size_t the index of the layout in HEADER_LAYOUTS
+     */
+    constexpr size_t get_header_layout_index(uint16_t frame_control){
+        size_t type = (frame_control >> 2) & 0x3;
+        size_t sub_type = (frame_control >> 4) & 0xF;
+        bool to_ds = frame_control & 0x0100;
+        bool from_ds = frame_control & 0x0200;
+        bool order = frame_control & 0x8000;
+        bool qos = type == TYPE_DATA && (sub_type & 0x8);
+
+        return type | (to_ds << 2) | (from_ds << 3) | (qos << 4) | (order << 5);
+    }
+
+    /**
+     * @brief Build the layout corresponding to a layout index
+     *
+     * @param index the layout index given by get_header_layout_index()
+     * @return Header_layout the layout
+     */
+    constexpr Header_layout make_header_layout(size_t index){
+        size_t type = index & 0x3;
+        bool to_ds = index & 0x04;
+        bool from_ds = index & 0x08;
+        bool qos = index & 0x10;
+        bool order = index & 0x20;
+
+        Header_layout layout = {0, NO_FIELD, NO_FIELD, NO_FIELD, NO_FIELD, NO_FIELD, NO_FIELD, NO_FIELD, NO_FIELD, NO_FIELD};
+
+        if(type == TYPE_MANAGEMENT){
+            layout.destination_address = 4;
+            layout.source_address = 10;
+            layout.bssid = 16;
+            layout.receiver_address = 4;
+            layout.transmitter_address = 10;
+            layout.sequence_control = 22;
+            layout.length = FRAME_HEADER_MIN_LENGTH;
+
+            // +HTC management frame
+            if(order){
+                layout.ht_control = layout.length;
+                layout.length += 4;
+            }
+        } else if(type == TYPE_DATA){
+            layout.receiver_address = 4;
+            layout.transmitter_address = 10;
+            layout.sequence_control = 22;
+            layout.length = FRAME_HEADER_MIN_LENGTH;
+
+            if(!to_ds && !from_ds){
+                layout.destination_address = 4;
+                layout.source_address = 10;
+                layout.bssid = 16;
+            } else if(!to_ds && from_ds){
+                layout.destination_address = 4;
+                layout.bssid = 10;
+                layout.source_address = 16;
+            } else if(to_ds && !from_ds){
+                layout.bssid = 4;
+                layout.source_address = 10;
+                layout.destination_address = 16;
+            } else {
+                layout.destination_address = 16;
+                layout.address_4 = layout.length;
+                layout.source_address = layout.length;
+                layout.length += 6;
+            }
+
+            if(qos){
+                layout.qos_control = layout.length;
+                layout.length += 2;
+
+                // The order bit means +HTC only for QoS data frames
+                if(order){
+                    layout.ht_control = layout.length;
+                    layout.length += 4;
+                }
+            }
+        }
+
+        return layout;
+    }
+
+    /**
+     * @brief Build the table of all layouts
+     *
+     * @return std::array<Header_layout, sizeof...(I)> the layouts, indexed by layout index
+     */
+    template<size_t... I>
+    constexpr std::array<Header_layout, sizeof...(I)> make_header_layouts(std::index_sequence<I...>){
+        return {{make_header_layout(I)...}};
+    }
+
+    /**
+     * @brief The table of all layouts, indexed by the index given by get_header_layout_index()
+     *
+     */
+    inline constexpr std::array<Header_layout, HEADER_LAYOUT_COUNT> HEADER_LAYOUTS =
+        make_header_layouts(std::make_index_sequence<HEADER_LAYOUT_COUNT>());
+
+    static_assert(HEADER_LAYOUTS[get_header_layout_index(0x0080)].length == FRAME_HEADER_MIN_LENGTH, "beacon header must be 24 bytes");
+    static_assert(HEADER_LAYOUTS[get_header_layout_index(0x8388)].length == FRAME_HEADER_MAX_LENGTH, "4 address QoS +HTC header must be 36 bytes");
+}
+
+#endif
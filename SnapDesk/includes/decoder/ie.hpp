@@ -25,6 +25,11 @@
 #define P_TIM 5 ///<element id 5 is the TIM
 #define P_IBSS 6 ///<element id 6 is the IBSS
 #define P_Challenge_text 16 ///<element 16 is the challenge text
+#define P_VENDOR_SPECIFIC 221 ///<element id 221 is a vendor specific IE, its content begins with an OUI
+#define P_EXTENSION 255 ///<element id 255 is an extension IE, its content begins with the extension id
+
+#define IE_OUI_LENGTH 3 ///<The byte length of the OUI of a vendor specific IE
+#define IE_SET_LENGTH 32 ///<The byte length of the set of the element ids of a body, one bit per id
 
 namespace decoder{
     /**
@@ -74,6 +79,13 @@ namespace decoder{
              * @return Big_number the value that correcpond to the field or null if none
              */
             Big_number get_value(std::string field) const;
+            /**
+             * @brief Find the first IE of the list with a given element id
+             * 
+             * @param _element_id the element id to look for
+             * @return const Big_number* the value of the IE, or nullptr if not found
+             */
+            const Big_number *find(uint8_t _element_id) const;
             /**
              * @brief Print the IE
              * 
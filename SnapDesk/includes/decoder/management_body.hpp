@@ -12,10 +12,13 @@
 #define MANAGEMENT_BODY_HPP
 
 #include <cstdint>
+#include <cstring>
 #include <const.hpp>
 #include <string>
+#include <vector>
 #include "decoder/frame.hpp"
 #include "decoder/ie.hpp"
+#include "decoder/sub_fields.hpp"
 #include "decoder/big_number.hpp"
 
 using namespace std;
@@ -32,6 +35,9 @@ namespace decoder{
             Big_number _beacon_interval; ///<The beacon interval fixed fields
             Big_number _capabilities_information; ///<The capabilities information fixed fields
             Ie_node *_first_ie = nullptr; ///<The linked list of body's IEs
+            std::vector<uint8_t> _ie_order; ///<The element id of each IE in its order, followed by the extension id or the OUI for the IEs 255 and 221
+            uint8_t _ie_set[IE_SET_LENGTH] = {}; ///<The element ids of the IEs, the bit of the id i is the bit i of this big endian number
+            Sub_fields _sub_fields; ///<The sub-fields of the known IEs
 
             /**
              * @brief decode the body and fill the fields
@@ -39,7 +45,7 @@ namespace decoder{
              */
             void decode() override;
             /**
-             * @brief Add an IE to the linked list
+             * @brief Add an IE to the linked list, to the order and to the set of the IEs
              * 
              * @param element_id the element id of the IE
              * @param element_length The byte length of the IE content
@@ -69,10 +75,11 @@ namespace decoder{
             /**
              * @brief Get the value of a specific field
              * 
-             * @param field the name of the field, or the element id corresponding to an IE
+             * @param field the name of the field, the name of a sub-field (as "ht.max_amsdu"), or the element id corresponding to an IE
              * @return Big_number the value, or null if this do not exist
              */
             Big_number get_value(string field) const override;
+            bool get_field(const Field &field, Span &span) const override;
     };
 }
 
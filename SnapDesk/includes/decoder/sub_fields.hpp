@@ -0,0 +1,291 @@
+/**
+ * @file sub_fields.hpp
+ * @author Pagano Florian
+ * @brief Decode the content of well known IEs (HT, VHT, HE, RSN and WPS) into named sub-fields
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef SUB_FIELDS_HPP
+#define SUB_FIELDS_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+#include "decoder/big_number.hpp"
+#include "decoder/field.hpp"
+
+#define P_HT_CAPABILITIES 45 ///<element id 45 is the HT capabilities
+#define P_RSN 48 ///<element id 48 is the RSN
+#define P_VHT_CAPABILITIES 191 ///<element id 191 is the VHT capabilities
+#define P_VENDOR_SPECIFIC 221 ///<element id 221 is a vendor specific element
+#define P_EXTENSION 255 ///<element id 255 is an element with an extension id
+#define P_EXT_HE_CAPABILITIES 35 ///<extension id 35 is the HE capabilities
+
+#define SUB_FIELDS_NUMBERS_SIZE 512 ///<The size of the buffer holding the decoded numbers
+
+namespace decoder{
+    /**
+     * @brief The id of every sub-field that can be decoded
+     *
+     */
+    enum Sub_field_id {
+        // HT capabilities
+        HT_CAPABILITIES,
+        HT_LDPC,
+        HT_CHANNEL_WIDTH,
+        HT_SM_POWER_SAVE,
+        HT_GREENFIELD,
+        HT_SHORT_GI_20,
+        HT_SHORT_GI_40,
+        HT_TX_STBC,
+        HT_RX_STBC,
+        HT_DELAYED_BLOCK_ACK,
+        HT_MAX_AMSDU,
+        HT_DSSS_CCK_40,
+        HT_FORTY_MHZ_INTOLERANT,
+        HT_LSIG_TXOP_PROTECTION,
+        HT_AMPDU_PARAMETERS,
+        HT_MAX_AMPDU_EXPONENT,
+        HT_MIN_MPDU_SPACING,
+        HT_MCS_SET,
+        HT_EXTENDED_CAPABILITIES,
+        HT_TXBF_CAPABILITIES,
+        HT_ASEL_CAPABILITIES,
+        // VHT capabilities
+        VHT_CAPABILITIES,
+        VHT_MAX_MPDU_LENGTH,
+        VHT_CHANNEL_WIDTH,
+        VHT_RX_LDPC,
+        VHT_SHORT_GI_80,
+        VHT_SHORT_GI_160,
+        VHT_TX_STBC,
+        VHT_RX_STBC,
+        VHT_SU_BEAMFORMER,
+        VHT_SU_BEAMFORMEE,
+        VHT_BEAMFORMEE_STS,
+        VHT_SOUNDING_DIMENSIONS,
+        VHT_MU_BEAMFORMER,
+        VHT_MU_BEAMFORMEE,
+        VHT_MAX_AMPDU_EXPONENT,
+        VHT_RX_MCS_MAP,
+        VHT_RX_HIGHEST_RATE,
+        VHT_TX_MCS_MAP,
+        VHT_TX_HIGHEST_RATE,
+        // HE capabilities
+        HE_MAC_CAPABILITIES,
+        HE_PHY_CAPABILITIES,
+        HE_MCS_NSS_SET,
+        HE_HTC_HE,
+        HE_TWT_REQUESTER,
+        HE_TWT_RESPONDER,
+        HE_CHANNEL_WIDTH_SET,
+        HE_LDPC_PAYLOAD,
+        HE_PPE_THRESHOLDS_PRESENT,
+        HE_SU_BEAMFORMER,
+        HE_SU_BEAMFORMEE,
+        HE_MU_BEAMFORMER,
+        HE_RX_MCS_80,
+        HE_TX_MCS_80,
+        // RSN
+        RSN_VERSION,
+        RSN_GROUP_CIPHER,
+        RSN_PAIRWISE_COUNT,
+        RSN_PAIRWISE_CIPHERS,
+        RSN_AKM_COUNT,
+        RSN_AKM_SUITES,
+        RSN_CAPABILITIES,
+        RSN_PREAUTHENTICATION,
+        RSN_PTKSA_REPLAY_COUNTER,
+        RSN_GTKSA_REPLAY_COUNTER,
+        RSN_MFP_REQUIRED,
+        RSN_MFP_CAPABLE,
+        RSN_PMKID_COUNT,
+        RSN_GROUP_MANAGEMENT_CIPHER,
+        // WPS
+        WPS_VERSION,
+        WPS_STATE,
+        WPS_AP_SETUP_LOCKED,
+        WPS_RESPONSE_TYPE,
+        WPS_UUID,
+        WPS_MANUFACTURER,
+        WPS_MODEL_NAME,
+        WPS_MODEL_NUMBER,
+        WPS_SERIAL_NUMBER,
+        WPS_DEVICE_NAME,
+        WPS_PRIMARY_DEVICE_TYPE,
+        WPS_CONFIG_METHODS,
+        WPS_RF_BANDS,
+        WPS_VENDOR_EXTENSION,
+
+        SUB_FIELD_COUNT
+    };
+
+    /**
+     * @brief This class hold the sub-fields of the IEs of a body, it is filled once when the body is decoded
+     * @class Sub_fields
+     *
+     * Numbers are stored big endian in a small internal buffer, and octet strings are kept as
+     * positions in the body buffer, so that no allocation is done while decoding.
+     *
+     */
+    class Sub_fields {
+        private:
+            const uint8_t *_raw_body_buffer = nullptr; ///<The buffer of the body containing the IEs
+            uint16_t _position[SUB_FIELD_COUNT]; ///<The position of each sub-field value, in the body buffer or in _numbers
+            uint16_t _length[SUB_FIELD_COUNT]; ///<The byte length of each sub-field value
+            bool _present[SUB_FIELD_COUNT]; ///<true if the sub-field has been decoded
+            bool _is_number[SUB_FIELD_COUNT]; ///<true if the value is in _numbers, false if it is in the body buffer
+            uint8_t _numbers[SUB_FIELDS_NUMBERS_SIZE]; ///<The decoded numbers, big endian
+            size_t _numbers_size = 0; ///<The number of bytes used in _numbers
+
+            /**
+             * @brief Store a sub-field that is a slice of the body buffer
+             *
+             * @param id the id of the sub-field
+             * @param position the position of the value in the body buffer
+             * @param length the byte length of the value
+             */
+            void _set_raw(Sub_field_id id, size_t position, size_t length);
+            /**
+             * @brief Store a sub-field that is a number
+             *
+             * @param id the id of the sub-field
+             * @param value the value of the number
+             * @param length the byte length of the number
+             */
+            void _set_number(Sub_field_id id, uint64_t value, size_t length);
+            /**
+             * @brief Store a little endian number read from the body buffer
+             *
+             * @param id the id of the sub-field
+             * @param position the position of the number in the body buffer
+             * @param length the byte length of the number
+             */
+            void _set_le_number(Sub_field_id id, size_t position, size_t length);
+            /**
+             * @brief Get the value of a number sub-field
+             *
+             * @param id the id of the sub-field
+             * @return uint64_t the value of the number
+             */
+            uint64_t _get_number(Sub_field_id id) const;
+            /**
+             * @brief Fill the bit fields that are extracted from an already decoded number
+             *
+             * @param first the first bit field to fill
+             * @param last the last bit field to fill
+             */
+            void _set_bit_fields(Sub_field_id first, Sub_field_id last);
+
+            /**
+             * @brief Decode an HT capabilities element
+             *
+             * @param position the position of the element content in the body buffer
+             * @param length the length of the element content
+             */
+            void _decode_ht(size_t position, size_t length);
+            /**
+             * @brief Decode a VHT capabilities element
+             *
+             * @param position the position of the element content in the body buffer
+             * @param length the length of the element content
+             */
+            void _decode_vht(size_t position, size_t length);
+            /**
+             * @brief Decode a HE capabilities element (after the extension id)
+             *
+             * @param position the position of the element content in the body buffer
+             * @param length the length of the element content
+             */
+            void _decode_he(size_t position, size_t length);
+            /**
+             * @brief Decode a RSN element
+             *
+             * @param position the position of the element content in the body buffer
+             * @param length the length of the element content
+             */
+            void _decode_rsn(size_t position, size_t length);
+            /**
+             * @brief Decode the attributes of a WPS vendor specific element (after the OUI and the type)
+             *
+             * @param position the position of the element content in the body buffer
+             * @param length the length of the element content
+             */
+            void _decode_wps(size_t position, size_t length);
+
+        public:
+            /**
+             * @brief Construct a new empty Sub_fields object
+             *
+             */
+            Sub_fields();
+
+            /**
+             * @brief Forget all sub-fields and attach the object to a body buffer
+             *
+             * @param raw_body_buffer the buffer of the body containing the IEs
+             */
+            void reset(const uint8_t *raw_body_buffer);
+            /**
+             * @brief Decode an IE if it is one of the known elements, do nothing otherwise
+             *
+             * Only the first occurrence of each element is decoded.
+             *
+             * @param element_id the element id of the IE
+             * @param position the position of the IE content in the body buffer
+             * @param length the length of the IE content
+             */
+            void decode_ie(uint8_t element_id, size_t position, size_t length);
+            /**
+             * @brief Get the value of a sub-field
+             *
+             * @param id the id of the sub-field
+             * @return Big_number the value or null if the sub-field is not present
+             */
+            Big_number get_value(Sub_field_id id) const;
+            /**
+             * @brief Get the value of a sub-field given its name
+             *
+             * @param field the name of the sub-field, as "ht.max_amsdu"
+             * @return Big_number the value or null if the sub-field is not present or unknown
+             */
+            Big_number get_value(std::string field) const;
+            /**
+             * @brief Get a view on the value of a sub-field, without copying it
+             *
+             * @param id the id of the sub-field
+             * @param span filled with the value if the sub-field is present
+             * @return true if the sub-field is present
+             */
+            bool get_span(Sub_field_id id, Span &span) const;
+            /**
+             * @brief Print all sub-fields that are present
+             *
+             */
+            void print() const;
+
+            /**
+             * @brief Get the id of a sub-field given its name
+             *
+             * @param field the name of the sub-field, as "ht.max_amsdu"
+             * @return size_t the id of the sub-field, or SUB_FIELD_COUNT if unknown
+             */
+            static size_t get_id(std::string field);
+            /**
+             * @brief Get the name of a sub-field
+             *
+             * @param id the id of the sub-field
+             * @return const char* the name of the sub-field
+             */
+            static const char *get_name(Sub_field_id id);
+    };
+}
+
+#endif
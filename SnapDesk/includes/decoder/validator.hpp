@@ -0,0 +1,122 @@
+/**
+ * @file validator.hpp
+ * @author Pagano Florian
+ * @brief Cheap checks of a raw frame made before decoding it
+ * @version 0.1
+ * @date 2025
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+#ifndef VALIDATOR_HPP
+#define VALIDATOR_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <const.hpp>
+
+#include "decoder/header_layout.hpp"
+
+namespace decoder{
+    /**
+     * @brief What must be done with a frame
+     * 
+     */
+    enum Verdict {
+        VERDICT_ACCEPT, ///<The frame can be decoded as is
+        VERDICT_TRUNCATE, ///<The frame can be decoded, but only up to the last consistent IE
+        VERDICT_DROP, ///<The frame must not be decoded
+    };
+
+    /**
+     * @brief Why a verdict has been given
+     * 
+     */
+    enum Validation_reason {
+        REASON_VALID, ///<Nothing is wrong (accept)
+        REASON_TOO_SHORT, ///<The frame is shorter than its frame control and FCS (drop)
+        REASON_UNSUPPORTED, ///<There is no header layout or no body decoder for the type and subtype (drop)
+        REASON_HEADER_TRUNCATED, ///<The frame is shorter than its header and FCS (drop)
+        REASON_BODY_TOO_SHORT, ///<The body is shorter than its fixed fields (drop)
+        REASON_IE_HEADER_TRUNCATED, ///<The body ends in the middle of an IE header (truncate)
+        REASON_IE_OVERFLOW, ///<The length of an IE goes past the end of the body (truncate)
+
+        REASON_COUNT
+    };
+
+    /**
+     * @brief The result of the validation of a frame
+     * 
+     */
+    struct Validation {
+        Verdict verdict; ///<What must be done with the frame
+        Validation_reason reason; ///<Why
+        size_t header_length; ///<The length of the MAC header
+        size_t body_length; ///<The length of the body that can be decoded, FCS excluded
+    };
+
+    /**
+     * @brief Classify raw frames as accept, truncate or drop, and count the outcomes per reason
+     * @class Validator
+     * 
+     * The validation never allocates and never throws, so that a garbage frame costs only a few comparisons.
+     * 
+     */
+    class Validator {
+        private:
+            size_t _counters[REASON_COUNT] = {}; ///<The number of frames seen for each reason
+
+            /**
+             * @brief Count and fill a validation
+             * 
+             * @param validation the validation to fill
+             * @param verdict the verdict
+             * @param reason the reason of the verdict
+             * @return Verdict the verdict
+             */
+            Verdict _conclude(Validation &validation, Verdict verdict, Validation_reason reason);
+
+        public:
+            /**
+             * @brief Check a raw frame
+             * 
+             * @param frame the raw frame, FCS included
+             * @param size the size of the frame
+             * @param validation filled with the verdict, the reason, and the lengths to decode
+             * @return Verdict the verdict
+             */
+            Verdict validate(const uint8_t *frame, size_t size, Validation &validation);
+
+            /**
+             * @brief Get the number of frames seen for a reason
+             * 
+             * @param reason the reason
+             * @return size_t the number of frames
+             */
+            size_t get_count(Validation_reason reason) const;
+            /**
+             * @brief Print the number of frames seen for each reason
+             * 
+             */
+            void print() const;
+
+            /**
+             * @brief Get the verdict corresponding to a reason
+             * 
+             * @param reason the reason
+             * @return Verdict the verdict
+             */
+            static Verdict get_verdict(Validation_reason reason);
+            /**
+             * @brief Get the name of a reason
+             * 
+             * @param reason the reason
+             * @return const char* the name of the reason
+             */
+            static const char *get_name(Validation_reason reason);
+    };
+}
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file hash.hpp
+ * @author Pagano Florian
+ * @brief The common interface of the hashes fed piece by piece
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#define HASH_MAX_LENGTH 32 ///<The byte length of the longest digest
+
+namespace digest{
+
+    /**
+     * @brief The hashes available to the scripts
+     *
+     */
+    enum Algorithm : uint8_t {
+        ALGORITHM_SHA256, ///<SHA-256, 32 bytes
+        ALGORITHM_XXH64, ///<XXH64 with the seed 0, 8 bytes
+        ALGORITHM_XXH128, ///<Two XXH64 with different seeds, 16 bytes
+        ALGORITHM_SIPHASH64, ///<Keyed SipHash-2-4, 8 bytes
+        ALGORITHM_SIPHASH128 ///<Keyed SipHash-2-4 with the 128 bits output, 16 bytes
+    };
+
+    /**
+     * @brief A hash fed piece by piece, the object is reused from one hash to the next
+     * @class Hash
+     *
+     */
+    class Hash{
+        public:
+            /**
+             * @brief Destroy the Hash object
+             *
+             */
+            virtual ~Hash() {};
+
+            /**
+             * @brief Start a new hash, the previous one is forgotten
+             *
+             */
+            virtual void begin() = 0;
+            /**
+             * @brief Add bytes to the current hash
+             *
+             * @param data the bytes
+             * @param size the number of bytes
+             */
+            virtual void update(const void *data, size_t size) = 0;
+            /**
+             * @brief Finish the current hash
+             *
+             * @param digest filled with the get_length() bytes of the digest
+             */
+            virtual void final(uint8_t *digest) = 0;
+            /**
+             * @brief Get the byte length of the digest
+             *
+             * @return size_t the byte length
+             */
+            virtual size_t get_length() const = 0;
+
+            /**
+             * @brief Create the hash of an algorithm
+             *
+             * @param algorithm the algorithm
+             * @param key the key of the keyed algorithms, empty for the others
+             * @return Hash* the new hash, to delete
+             */
+            static Hash *create(Algorithm algorithm, const std::string &key);
+            /**
+             * @brief Get the byte length of the digest of an algorithm
+             *
+             * @param algorithm the algorithm
+             * @return size_t the byte length
+             */
+            static size_t get_length(Algorithm algorithm);
+            /**
+             * @brief Get the byte length of the key of an algorithm
+             *
+             * @param algorithm the algorithm
+             * @return size_t the byte length, 0 if the algorithm is not keyed
+             */
+            static size_t get_key_length(Algorithm algorithm);
+            /**
+             * @brief Get the name of an algorithm, for the listings
+             *
+             * @param algorithm the algorithm
+             * @return const char* the name
+             */
+            static const char *get_name(Algorithm algorithm);
+    };
+}
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file sha256.hpp
+ * @author Pagano Florian
+ * @brief Streaming SHA-256 on a reused OpenSSL context
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef SHA256_HPP
+#define SHA256_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+
+#include "digest/hash.hpp"
+
+#define SHA256_LENGTH SHA256_DIGEST_LENGTH ///<The byte length of a SHA-256 digest
+
+namespace digest{
+
+    /**
+     * @brief A SHA-256 hash fed piece by piece, the OpenSSL context and algorithm are created once and reused
+     * @class Sha256
+     *
+     * Creating and initialising a context costs more than hashing the few bytes of a fingerprint,
+     * so each Sha256 object keeps its context from one hash to the next.
+     *
+     */
+    class Sha256 : public Hash{
+        private:
+            EVP_MD_CTX *_context; ///<The reused context
+
+            /**
+             * @brief Get the SHA-256 algorithm, fetched once for the whole program
+             *
+             * @return const EVP_MD* the algorithm
+             */
+            static const EVP_MD *_get_algorithm();
+
+        public:
+            /**
+             * @brief Construct a new Sha256 object and its context
+             *
+             */
+            Sha256();
+            /**
+             * @brief Destroy the Sha256 object and its context
+             *
+             */
+            ~Sha256() override;
+
+            Sha256(const Sha256 &) = delete;
+            Sha256 &operator=(const Sha256 &) = delete;
+
+            void begin() override;
+            void update(const void *data, size_t size) override;
+            void final(uint8_t *digest) override;
+            size_t get_length() const override;
+
+            /**
+             * @brief Get the instance of the calling thread, for the one shot hashes
+             *
+             * @return Sha256& the instance, destroyed with the thread
+             */
+            static Sha256 &get_thread_instance();
+            /**
+             * @brief Finalize the digest and give its lowercase hex
+             *
+             * @return std::string the 64 hex digits of the digest
+             */
+            std::string hex_final();
+            /**
+             * @brief Hash a string and give the lowercase hex of the digest
+             *
+             * @param data the string to hash
+             * @return std::string the 64 hex digits of the digest
+             */
+            static std::string hex_digest(const std::string &data);
+    };
+}
+
+#endif
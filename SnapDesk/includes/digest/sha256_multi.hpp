@@ -0,0 +1,134 @@
+/**
+ * @file sha256_multi.hpp
+ * @author Pagano Florian
+ * @brief SHA-256 of many independent messages at once, one message per SIMD lane
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef SHA256_MULTI_HPP
+#define SHA256_MULTI_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#if defined(__aarch64__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+#include "digest/sha256.hpp"
+
+#define SHA256_BLOCK 64 ///<The byte length of a block of SHA-256
+#define SHA256_MAX_LANES 8 ///<The number of messages hashed together by the widest kernel
+
+namespace digest{
+
+    /**
+     * @brief The implementations of Sha256_multi
+     *
+     */
+    enum Sha256_kernel {
+        SHA256_KERNEL_SCALAR, ///<One message at a time, in portable C++
+        SHA256_KERNEL_NEON, ///<4 messages in the 32 bits lanes of NEON (ARM)
+        SHA256_KERNEL_AVX2 ///<8 messages in the 32 bits lanes of AVX2 (x86)
+    };
+
+    /**
+     * @brief The SHA-256 of whole messages, computed by groups of independent messages
+     * @class Sha256_multi
+     *
+     * A single SHA-256 is a chain of dependent rounds, so one message leaves most of a vector unit idle.
+     * Here each lane of a vector holds the state of another message: the rounds of 4 or 8 messages run
+     * in the instructions of one. The messages may have different lengths, a lane whose message has no
+     * block left keeps its state while the others go on.
+     *
+     * The messages must be complete, the streaming hashes stay with Sha256.
+     *
+     */
+    class Sha256_multi{
+        private:
+            /**
+             * @brief Hash a group of messages with a kernel
+             *
+             * @tparam LANES the number of messages of the group, the width of the kernel
+             * @tparam COMPRESS the compression of one block of each lane
+             * @param messages the messages of the group, count <= LANES
+             * @param sizes the byte length of each message
+             * @param count the number of messages
+             * @param digests the SHA256_LENGTH bytes of each digest, one after the other
+             */
+            template<size_t LANES, void (*COMPRESS)(uint32_t (*)[LANES], const uint32_t (*)[LANES], const uint32_t *)>
+            static void _hash_group(const uint8_t *const *messages, const size_t *sizes, size_t count, uint8_t *digests);
+
+        public:
+            /**
+             * @brief Get the widest kernel supported by the processor running the program
+             *
+             * @return Sha256_kernel the kernel, tested once
+             */
+            static Sha256_kernel get_best_kernel();
+            /**
+             * @brief Tell if a kernel can run on the processor running the program
+             *
+             * @param kernel the kernel
+             * @return true if it is compiled in and supported by the processor
+             */
+            static bool is_supported(Sha256_kernel kernel);
+            /**
+             * @brief Get the name of a kernel
+             *
+             * @param kernel the kernel
+             * @return const char* "scalar", "neon" or "avx2"
+             */
+            static const char *get_name(Sha256_kernel kernel);
+            /**
+             * @brief Get the number of messages a kernel hashes at once
+             *
+             * @param kernel the kernel
+             * @return size_t 1, 4 or 8
+             */
+            static size_t get_lanes(Sha256_kernel kernel);
+            /**
+             * @brief Tell if the processor has SHA-256 instructions (SHA-NI on x86, the SHA2 extension on ARM)
+             *
+             * OpenSSL uses them when they are there, and hashes one message faster than the lanes of any kernel.
+             *
+             * @return true if it has them, tested once
+             */
+            static bool has_sha_instructions();
+            /**
+             * @brief Tell if the widest kernel is faster than OpenSSL on the processor running the program
+             *
+             * @return true if it is a vector kernel and the processor has no SHA-256 instructions
+             */
+            static bool is_preferred();
+
+            /**
+             * @brief Hash messages, by groups of get_lanes() messages
+             *
+             * @param messages the start of each message
+             * @param sizes the byte length of each message
+             * @param count the number of messages
+             * @param digests filled with the SHA256_LENGTH bytes of each digest, one after the other
+             * @param kernel the kernel, it must be supported
+             */
+            static void digest(const uint8_t *const *messages, const size_t *sizes, size_t count, uint8_t *digests,
+                Sha256_kernel kernel = get_best_kernel());
+    };
+}
+
+#endif
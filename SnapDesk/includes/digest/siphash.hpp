@@ -0,0 +1,73 @@
+/**
+ * @file siphash.hpp
+ * @author Pagano Florian
+ * @brief The keyed SipHash-2-4 hash, with a 64 or 128 bits output
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef SIPHASH_HPP
+#define SIPHASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "digest/hash.hpp"
+
+#define SIPHASH_KEY_LENGTH 16 ///<The byte length of a SipHash key
+#define SIPHASH_BLOCK 8 ///<The bytes consumed by one compression
+
+namespace digest{
+
+    /**
+     * @brief SipHash-2-4, the digest is written as the reference implementation writes it (little endian)
+     * @class Siphash
+     *
+     * Unlike XXH64, the rounds of a single message depend on each other, so there is no vectorized path.
+     *
+     */
+    class Siphash : public Hash{
+        private:
+            uint64_t _key[2]; ///<The key, as two little endian words
+            size_t _length; ///<The byte length of the digest, 8 or 16
+            uint64_t _state[4]; ///<The four words of the state
+            uint8_t _buffer[SIPHASH_BLOCK]; ///<The bytes waiting for a full block
+            size_t _buffered; ///<The number of bytes in _buffer
+            uint64_t _total; ///<The number of bytes hashed
+
+            /**
+             * @brief Compress one block in the state
+             *
+             * @param block the block, as a little endian word
+             */
+            void _compress(uint64_t block);
+            /**
+             * @brief Apply SipRound to the state
+             *
+             * @param count the number of rounds
+             */
+            void _rounds(size_t count);
+
+        public:
+            /**
+             * @brief Construct a new Siphash object
+             *
+             * @param key the SIPHASH_KEY_LENGTH bytes of the key
+             * @param length the byte length of the digest, 8 or 16
+             */
+            Siphash(const std::string &key, size_t length);
+
+            void begin() override;
+            void update(const void *data, size_t size) override;
+            void final(uint8_t *digest) override;
+            size_t get_length() const override;
+    };
+}
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file xxh64.hpp
+ * @author Pagano Florian
+ * @brief The XXH64 non cryptographic hash
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef XXH64_HPP
+#define XXH64_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "digest/hash.hpp"
+
+#define XXH64_LENGTH 8 ///<The byte length of a XXH64 digest
+#define XXH128_LENGTH 16 ///<The byte length of a Xxh128 digest
+#define XXH64_STRIPE 32 ///<The bytes consumed by one round of the four lanes
+
+namespace digest{
+
+    /**
+     * @brief XXH64, as the reference implementation, the digest is written big endian (canonical form)
+     * @class Xxh64
+     *
+     * The inputs are consumed by stripes of XXH64_STRIPE bytes, split between four independent lanes.
+     * The lanes stay in general purpose registers: without a native 64 bits vector multiplication
+     * (AVX2), or with a slow one (AVX-512), the vectorized loop is slower.
+     *
+     */
+    class Xxh64 : public Hash{
+        private:
+            uint64_t _seed; ///<The seed
+            uint64_t _lanes[4]; ///<The four accumulators
+            uint8_t _buffer[XXH64_STRIPE]; ///<The bytes waiting for a full stripe
+            size_t _buffered; ///<The number of bytes in _buffer
+            uint64_t _total; ///<The number of bytes hashed
+
+            /**
+             * @brief Consume whole stripes in the lanes
+             *
+             * @param lanes the four accumulators
+             * @param data the stripes
+             * @param count the number of stripes
+             */
+            static void _consume(uint64_t *lanes, const uint8_t *data, size_t count);
+
+        public:
+            /**
+             * @brief Construct a new Xxh64 object
+             *
+             * @param seed the seed of the hashes
+             */
+            Xxh64(uint64_t seed = 0);
+
+            void begin() override;
+            void update(const void *data, size_t size) override;
+            void final(uint8_t *digest) override;
+            size_t get_length() const override;
+
+            /**
+             * @brief Finish the current hash
+             *
+             * @return uint64_t the hash
+             */
+            uint64_t final_value() const;
+    };
+
+    /**
+     * @brief A 128 bits hash made of two XXH64 with different seeds, the first one written first
+     * @class Xxh128
+     *
+     * It is not XXH3-128: the digests differ from the ones of the xxHash library.
+     *
+     */
+    class Xxh128 : public Hash{
+        private:
+            Xxh64 _high; ///<The hash with the seed 0
+            Xxh64 _low; ///<The hash with the second seed
+
+        public:
+            /**
+             * @brief Construct a new Xxh128 object
+             *
+             */
+            Xxh128();
+
+            void begin() override;
+            void update(const void *data, size_t size) override;
+            void final(uint8_t *digest) override;
+            size_t get_length() const override;
+    };
+}
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file file_watcher.hpp
+ * @author Pagano Florian
+ * @brief Wait for files to be modified, with inotify
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#ifndef FILE_WATCHER_HPP
+#define FILE_WATCHER_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#define FILE_WATCHER_SETTLE_MS 100 ///<The time without event after which a modification is over
+
+using namespace std;
+
+namespace os_communicator{
+
+    /**
+     * @brief Watch files for modifications
+     * @class File_watcher
+     *
+     * The directories of the files are watched instead of the files themselves, so that a file
+     * replaced by an editor (written elsewhere then renamed) is still seen.
+     *
+     */
+    class File_watcher{
+        private:
+            int _file_descriptor; ///<The inotify instance
+            vector<pair<int, string>> _files; ///<The watch descriptor of the directory and the name of each file
+
+        public:
+            /**
+             * @brief Construct a new File_watcher object
+             *
+             * @param file_names the paths of the files to watch
+             */
+            File_watcher(const vector<string> &file_names);
+            /**
+             * @brief Destroy the File_watcher object
+             *
+             */
+            ~File_watcher();
+
+            File_watcher(const File_watcher &) = delete;
+            File_watcher &operator=(const File_watcher &) = delete;
+
+            /**
+             * @brief Block until one of the files has been written, and for FILE_WATCHER_SETTLE_MS after the last event
+             *
+             */
+            void wait();
+    };
+}
+
+#endif
@@ -22,6 +22,8 @@
 #include <chrono>
 #include <thread>
 #include <filesystem>
+#include <csignal>
+#include <unistd.h>
 
 #define F_NONE 0 ///<A file that does not exist
 #define F_FILE 1 ///<A file
@@ -70,6 +72,12 @@ namespace os_communicator{
              * @return string the line
              */
             string get_line(size_t line_number) const;
+            /**
+             * @brief Get the whole content of the file, read at once
+             * 
+             * @return string the content of the file
+             */
+            string get_content() const;
             /**
              * @brief Add a line at the end of the file
              * 
@@ -88,6 +96,26 @@ namespace os_communicator{
              * 
              */
             void new_file();
+            /**
+             * @brief Replace the whole content of the file at once
+             * 
+             * The content is written to a temporary file renamed over the file, so a reader gets the old content
+             * or the new one, never a part of it.
+             * 
+             * @param content the new content of the file
+             */
+            void replace_content(const string &content);
+            /**
+             * @brief Rename the file, the Communicator still interacts with the old name
+             * 
+             * @param new_name the new name of the file, replaced if it exists
+             */
+            void rename_to(string new_name);
+            /**
+             * @brief Delete the file, if it exists
+             * 
+             */
+            void remove();
 
             /**
              * @brief Get the current date
@@ -107,6 +135,20 @@ namespace os_communicator{
              * @param seconds the number of seconds to pause the process
              */
             static void sleep(size_t seconds);
+            /**
+             * @brief Start to record the reception of a signal, instead of its default action
+             * 
+             * @param signal_number the signal to record (as SIGUSR1)
+             */
+            static void watch_signal(int signal_number);
+            /**
+             * @brief Tell if a watched signal has been received since the last call
+             * 
+             * @param signal_number the watched signal
+             * @return true if the signal has been received
+             * @return false if the signal has not been received
+             */
+            static bool signal_received(int signal_number);
             
             /**
              * @brief Create a folder
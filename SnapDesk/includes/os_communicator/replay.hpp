@@ -0,0 +1,88 @@
+/**
+ * @file replay.hpp
+ * @author Pagano Florian
+ * @brief Read the frames of a capture file to replay them
+ * @version 0.1
+ * @date 2025
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+
+#define PCAP_GLOBAL_HEADER_SIZE 24 ///<The size of the global header of a pcap file
+#define PCAP_RECORD_HEADER_SIZE 16 ///<The size of the header of each record of a pcap file
+#define LINKTYPE_IEEE802_11 105 ///<Raw 802.11 frames, with their FCS
+#define LINKTYPE_IEEE802_11_RADIOTAP 127 ///<802.11 frames preceded by a radiotap header
+#define RADIOTAP_FLAGS_FCS 0x10 ///<Radiotap flag telling that the frame contains its FCS
+
+using namespace std;
+
+namespace os_communicator{
+
+    /**
+     * @brief Load all frames of a pcap file in memory, they are given as the character device would give them
+     * @class Replay
+     * 
+     */
+    class Replay{
+        private:
+            vector<uint8_t> _frames; ///<The frames, one after the other
+            vector<const uint8_t *> _frame_pointers; ///<The start of each frame in _frames
+            vector<size_t> _frame_sizes; ///<The size of each frame
+
+            /**
+             * @brief Add a frame to the replay
+             * 
+             * @param frame the frame, FCS included if has_fcs is true
+             * @param size the size of the frame
+             * @param has_fcs false if the FCS is missing, a zero FCS is then added
+             */
+            void _add_frame(const uint8_t *frame, size_t size, bool has_fcs);
+
+        public:
+            /**
+             * @brief Load all frames of a pcap file
+             * 
+             * @param file_name the name of the pcap file (linktype 105 or 127)
+             */
+            Replay(string file_name);
+            /**
+             * @brief Create a replay from frames already in memory
+             * 
+             * @param frames the frames, FCS included
+             */
+            Replay(const vector<vector<uint8_t>> &frames);
+
+            /**
+             * @brief Get the number of frames
+             * 
+             * @return size_t the number of frames
+             */
+            size_t size() const;
+            /**
+             * @brief Get the start of each frame
+             * 
+             * @return const uint8_t* const* an array of size() pointers
+             */
+            const uint8_t *const *get_frames() const;
+            /**
+             * @brief Get the size of each frame
+             * 
+             * @return const size_t* an array of size() sizes
+             */
+            const size_t *get_sizes() const;
+    };
+}
+
+#endif
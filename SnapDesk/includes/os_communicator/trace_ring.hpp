@@ -0,0 +1,167 @@
+/**
+ * @file trace_ring.hpp
+ * @author Pagano Florian
+ * @brief A binary ring of per frame traces, written in a memory-mapped file
+ * @version 0.1
+ * @date 2025
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ */
+
+#ifndef TRACE_RING_HPP
+#define TRACE_RING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <ctime>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "const.hpp"
+
+#define TRACE_MAGIC "SNAPTRC" ///<The magic at the beginning of a trace file
+#define TRACE_VERSION 1 ///<The version of the trace file format
+#define TRACE_DEFAULT_SLOTS 1024 ///<The default number of frames kept in a trace file
+#define TRACE_OUTPUT_MAX_LENGTH 512 ///<The max length of the output kept for a frame
+
+using namespace std;
+
+namespace os_communicator{
+
+    /**
+     * @brief The header of a trace file
+     * 
+     */
+    struct Trace_header {
+        char magic[8]; ///<TRACE_MAGIC
+        uint32_t version; ///<TRACE_VERSION
+        uint32_t slot_count; ///<The number of slots of the ring
+        uint32_t slot_size; ///<The size of a slot, to detect incompatible files
+        uint32_t reserved; ///<Padding
+        atomic<uint64_t> write_index; ///<The index of the next trace to write
+    };
+
+    /**
+     * @brief A slot of the ring, holding the trace of one frame
+     * 
+     * The sequence is odd while the slot is written, and 2*(index+1) once the trace number index is complete.
+     * 
+     */
+    struct Trace_slot {
+        atomic<uint64_t> sequence; ///<The state of the slot
+        uint64_t timestamp; ///<The reception time of the frame, in ns since epoch
+        uint16_t frame_size; ///<The size of the raw frame
+        uint16_t output_size; ///<The size of the output
+        uint8_t verdict; ///<The verdict of the validation
+        uint8_t reason; ///<The reason of the verdict
+        uint8_t reserved[2]; ///<Padding
+        uint8_t frame[FRAME_MAX_LENGTH]; ///<The raw frame
+        char output[TRACE_OUTPUT_MAX_LENGTH]; ///<The output of the evaluation, or empty
+    };
+
+    /**
+     * @brief A copy of the trace of one frame
+     * 
+     */
+    struct Trace_record {
+        uint64_t index; ///<The number of the trace since the creation of the file
+        uint64_t timestamp; ///<The reception time of the frame, in ns since epoch
+        uint8_t verdict; ///<The verdict of the validation
+        uint8_t reason; ///<The reason of the verdict
+        vector<uint8_t> frame; ///<The raw frame
+        string output; ///<The output of the evaluation
+    };
+
+    /**
+     * @brief A ring of frame traces in a memory-mapped file, writers never lock and never do a system call
+     * @class Trace_ring
+     * 
+     */
+    class Trace_ring{
+        private:
+            int _file_descriptor; ///<The opened trace file
+            size_t _mapped_size; ///<The size of the mapping
+            Trace_header *_header; ///<The header, at the beginning of the mapping
+            Trace_slot *_slots; ///<The slots, after the header
+
+            static_assert(atomic<uint64_t>::is_always_lock_free, "the trace ring needs lock free 64 bits atomics");
+
+            /**
+             * @brief Map the opened file and find the header and the slots
+             * 
+             * @param writable true to map the file for writing
+             */
+            void _map(bool writable);
+            /**
+             * @brief Construct a new Trace_ring object on an opened file, for writing
+             * 
+             * @param file_descriptor the opened trace file
+             * @param mapped_size the size of the file
+             */
+            Trace_ring(int file_descriptor, size_t mapped_size);
+
+        public:
+            /**
+             * @brief Construct a new Trace_ring object on a trace file that does exist, for reading
+             * 
+             * @param file_name the name of the trace file
+             */
+            Trace_ring(string file_name);
+            /**
+             * @brief Destroy the Trace_ring object
+             * 
+             */
+            ~Trace_ring();
+            /**
+             * @brief Create a new trace file, an existing one is overwritten
+             * 
+             * @param file_name the name of the trace file
+             * @param slot_count the number of frames kept in the ring
+             * @return Trace_ring* the new Trace_ring instance, for writing
+             */
+            static Trace_ring *create(string file_name, size_t slot_count);
+
+            /**
+             * @brief Write the trace of a frame, overwriting the oldest one
+             * 
+             * @param frame the raw frame
+             * @param frame_size the size of the raw frame
+             * @param verdict the verdict of the validation
+             * @param reason the reason of the verdict
+             * @param output the output of the evaluation (truncated to TRACE_OUTPUT_MAX_LENGTH)
+             */
+            void write(const uint8_t *frame, size_t frame_size, uint8_t verdict, uint8_t reason, const string &output);
+            /**
+             * @brief Get the number of traces written since the creation of the file
+             * 
+             * @return uint64_t the number of traces
+             */
+            uint64_t get_write_index() const;
+            /**
+             * @brief Get the number of slots of the ring
+             * 
+             * @return size_t the number of slots
+             */
+            size_t get_slot_count() const;
+            /**
+             * @brief Copy a trace
+             * 
+             * @param index the number of the trace, between get_write_index()-get_slot_count() and get_write_index()-1
+             * @param record filled with the trace
+             * @return true if the trace has been copied
+             * @return false if the trace has been overwritten or is being written
+             */
+            bool read(uint64_t index, Trace_record &record) const;
+    };
+}
+
+#endif
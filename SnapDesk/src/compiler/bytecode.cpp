@@ -0,0 +1,504 @@
+#include "compiler/bytecode.hpp"
+
+using namespace bytecode;
+
+uint16_t Program::new_register(size_t width) {
+    if(_register_count >= MAX_REGISTERS)
+        throw std::runtime_error("Too many registers in program");
+
+    _widths.push_back(width);
+    _register_constants.push_back(SIZE_MAX);
+
+    return (uint16_t) _register_count++;
+}
+
+uint16_t Program::load_constant(const std::string &bytes, Encoding encoding) {
+    auto loaded = _constant_registers.find({bytes, encoding});
+    if(loaded != _constant_registers.end())
+        return loaded->second;
+
+    uint16_t destination = new_register(bytes.size());
+    _constant_registers[{bytes, encoding}] = destination;
+
+    _constants.push_back({bytes, encoding});
+    _register_constants[destination] = _constants.size() - 1;
+
+    emit(OP_LOAD_CONST, destination, (uint16_t) (_constants.size() - 1));
+
+    return destination;
+}
+
+uint16_t Program::load_field(const std::string &name) {
+    decoder::Field field = decoder::Frame::resolve_field(name);
+
+    auto loaded = _field_registers.find({field.kind, field.id});
+    if(loaded != _field_registers.end())
+        return loaded->second;
+
+    _fields.push_back(field);
+    _field_names.push_back(name);
+
+    uint16_t destination = new_register(decoder::Frame::get_field_width(field));
+    _field_registers[{field.kind, field.id}] = destination;
+
+    emit(OP_LOAD_FIELD, destination, (uint16_t) (_fields.size() - 1));
+
+    return destination;
+}
+
+uint16_t Program::slice(Opcode opcode, uint16_t source, uint16_t from, uint16_t size) {
+    if(opcode != OP_SLICE_BIT && opcode != OP_SLICE_BYTE)
+        throw std::invalid_argument("Not a cut");
+
+    auto loaded = _slice_registers.find({opcode, source, from, size});
+    if(loaded != _slice_registers.end())
+        return loaded->second;
+
+    uint16_t destination = new_register(opcode == OP_SLICE_BIT ? (size + 7) / 8 : size);
+    _slice_registers[{opcode, source, from, size}] = destination;
+
+    emit(opcode, destination, source, from, size);
+
+    return destination;
+}
+
+uint16_t Program::add_output() {
+    return (uint16_t) _output_count++;
+}
+
+uint16_t Program::add_hash(digest::Algorithm algorithm, const std::string &key) {
+    if(_hashes.size() >= MAX_REGISTERS)
+        throw std::runtime_error("Too many hashes in program");
+
+    _hashes.push_back({algorithm, key});
+
+    return (uint16_t) (_hashes.size() - 1);
+}
+
+uint16_t Program::final_hash(uint16_t slot, size_t begin) {
+    if(slot >= _hashes.size() || begin >= _code.size() || _code[begin].opcode != OP_HASH_BEGIN || _code[begin].first != slot)
+        throw std::invalid_argument("Not the beginning of the hash");
+
+    uint16_t destination = new_register(digest::Hash::get_length(_hashes[slot].algorithm));
+    emit(OP_HASH_FINAL, destination, slot);
+
+    // The arguments of a hash computed before are already loaded, so its copy is only made of its own instructions
+    std::vector<std::pair<uint16_t, uint16_t>> updates;
+    bool is_copy = true;
+    for(size_t i = begin + 1; i < _code.size() - 1; ++i){
+        if(_code[i].opcode == OP_HASH_UPDATE && _code[i].second == slot)
+            updates.push_back({_code[i].first, _code[i].third});
+        else
+            is_copy = false;
+    }
+
+    auto key = std::make_tuple(_hashes[slot].algorithm, _hashes[slot].key, updates);
+    auto computed = _hash_registers.find(key);
+    if(computed == _hash_registers.end() || !is_copy || slot != _hashes.size() - 1){
+        _hash_registers.emplace(key, destination);
+        return destination;
+    }
+
+    _code.resize(begin);
+    _hashes.pop_back();
+    _widths.pop_back();
+    _register_constants.pop_back();
+    _register_count--;
+
+    return computed->second;
+}
+
+void Program::set_script(uint16_t script) {
+    _script = script;
+}
+
+uint32_t Program::set_line(uint32_t line) {
+    uint32_t previous = _line;
+    _line = line;
+
+    return previous;
+}
+
+void Program::emit(Opcode opcode, uint16_t destination, uint16_t first, uint16_t second, uint16_t third) {
+    _code.push_back({opcode, destination, first, second, third, _script, _line});
+}
+
+const std::vector<Instruction> &Program::get_code() const {
+    return _code;
+}
+
+const std::vector<Constant> &Program::get_constants() const {
+    return _constants;
+}
+
+const std::vector<decoder::Field> &Program::get_fields() const {
+    return _fields;
+}
+
+const std::vector<Hash_slot> &Program::get_hashes() const {
+    return _hashes;
+}
+
+size_t Program::get_output_count() const {
+    return _output_count;
+}
+
+size_t Program::get_register_count() const {
+    return _register_count;
+}
+
+size_t Program::get_width(uint16_t value) const {
+    return _widths.at(value);
+}
+
+const Constant *Program::get_constant(uint16_t value) const {
+    size_t constant = _register_constants.at(value);
+
+    if(constant >= _constants.size())
+        return nullptr;
+
+    return &_constants[constant];
+}
+
+void Program::remove_unused() {
+    std::vector<bool> used(_register_count, false);
+    std::vector<Instruction> code;
+
+    // Every register is written once before being read, so a single backward pass finds all the used ones
+    for(size_t i = _code.size(); i-- > 0;){
+        const Instruction &instruction = _code[i];
+
+        // The hashes are kept whole, the other operations only if their result is used
+        bool has_destination = instruction.opcode == OP_LOAD_CONST || instruction.opcode == OP_LOAD_FIELD
+            || instruction.opcode == OP_SLICE_BIT || instruction.opcode == OP_SLICE_BYTE;
+
+        if(has_destination && !used[instruction.destination])
+            continue;
+
+        switch(instruction.opcode){
+        case OP_SLICE_BIT:
+        case OP_SLICE_BYTE:
+        case OP_HASH_UPDATE:
+        case OP_EMIT:
+            used[instruction.first] = true;
+            break;
+        default:
+            break;
+        }
+
+        code.push_back(instruction);
+    }
+
+    _code.assign(code.rbegin(), code.rend());
+}
+
+std::string Program::get_shared_values() const {
+    std::vector<size_t> reads(_register_count, 0);
+    std::vector<size_t> writers(_register_count, _code.size());
+
+    for(size_t i = 0; i < _code.size(); ++i){
+        switch(_code[i].opcode){
+        case OP_SLICE_BIT:
+        case OP_SLICE_BYTE:
+            reads[_code[i].first]++;
+            writers[_code[i].destination] = i;
+            break;
+        case OP_HASH_UPDATE:
+        case OP_EMIT:
+            reads[_code[i].first]++;
+            break;
+        case OP_LOAD_CONST:
+        case OP_LOAD_FIELD:
+        case OP_HASH_FINAL:
+            writers[_code[i].destination] = i;
+            break;
+        default:
+            break;
+        }
+    }
+
+    // The line of the instruction writing a shared register, from the listing
+    std::vector<std::string> lines;
+    std::string listing = to_string();
+    for(size_t start = 0, end; (end = listing.find('\n', start)) != std::string::npos; start = end + 1)
+        lines.push_back(listing.substr(start, end - start));
+
+    std::string output = "";
+    for(size_t value = 0; value < _register_count; ++value)
+        if(reads[value] > 1 && writers[value] < lines.size())
+            output += lines[writers[value]] + " (read " + std::to_string(reads[value]) + " times)\n";
+
+    return output;
+}
+
+/**
+ * @brief Append an integer to serialized bytes, little endian
+ * 
+ * @param bytes the bytes
+ * @param value the integer
+ * @param size the number of bytes of the integer
+ */
+static void write_integer(std::string &bytes, uint64_t value, size_t size){
+    for(size_t i = 0; i < size; ++i)
+        bytes.push_back((char) (value >> (8*i)));
+}
+
+/**
+ * @brief Append a string to serialized bytes, after its length
+ * 
+ * @param bytes the bytes
+ * @param text the string
+ */
+static void write_string(std::string &bytes, const std::string &text){
+    write_integer(bytes, text.size(), 4);
+    bytes += text;
+}
+
+/**
+ * @brief Read an integer written by write_integer()
+ * 
+ * @param position the position of the integer, set to the position after it
+ * @param end the end of the bytes
+ * @param size the number of bytes of the integer
+ * @return uint64_t the integer
+ */
+static uint64_t read_integer(const uint8_t *&position, const uint8_t *end, size_t size){
+    if((size_t) (end - position) < size)
+        throw std::runtime_error("The program is truncated");
+
+    uint64_t value = 0;
+    for(size_t i = 0; i < size; ++i)
+        value |= (uint64_t) *position++ << (8*i);
+
+    return value;
+}
+
+/**
+ * @brief Read a string written by write_string()
+ * 
+ * @param position the position of the string, set to the position after it
+ * @param end the end of the bytes
+ * @return std::string the string
+ */
+static std::string read_string(const uint8_t *&position, const uint8_t *end){
+    size_t size = read_integer(position, end, 4);
+    if((size_t) (end - position) < size)
+        throw std::runtime_error("The program is truncated");
+
+    std::string text((const char *) position, size);
+    position += size;
+
+    return text;
+}
+
+std::string Program::serialize() const {
+    std::string bytes = "";
+
+    write_integer(bytes, _register_count, 4);
+    write_integer(bytes, _output_count, 4);
+
+    write_integer(bytes, _constants.size(), 4);
+    for(const Constant &constant : _constants){
+        write_integer(bytes, constant.encoding, 1);
+        write_string(bytes, constant.bytes);
+    }
+
+    write_integer(bytes, _field_names.size(), 4);
+    for(const std::string &name : _field_names)
+        write_string(bytes, name);
+
+    write_integer(bytes, _hashes.size(), 4);
+    for(const Hash_slot &slot : _hashes){
+        write_integer(bytes, slot.algorithm, 1);
+        write_string(bytes, slot.key);
+    }
+
+    write_integer(bytes, _code.size(), 4);
+    for(const Instruction &instruction : _code){
+        write_integer(bytes, instruction.opcode, 1);
+        write_integer(bytes, instruction.destination, 2);
+        write_integer(bytes, instruction.first, 2);
+        write_integer(bytes, instruction.second, 2);
+        write_integer(bytes, instruction.third, 2);
+        write_integer(bytes, instruction.script, 2);
+        write_integer(bytes, instruction.line, 4);
+    }
+
+    return bytes;
+}
+
+Program *Program::deserialize(const uint8_t *data, size_t size) {
+    if(!data)
+        throw std::invalid_argument("No program given");
+
+    const uint8_t *position = data;
+    const uint8_t *end = data + size;
+    Program *program = new Program();
+
+    try{
+        program->_register_count = read_integer(position, end, 4);
+        program->_output_count = read_integer(position, end, 4);
+        if(program->_register_count > MAX_REGISTERS || program->_output_count > MAX_REGISTERS)
+            throw std::runtime_error("Too many registers in program");
+
+        size_t count = read_integer(position, end, 4);
+        for(size_t i = 0; i < count; ++i){
+            Encoding encoding = (Encoding) read_integer(position, end, 1);
+            if(encoding > ENCODING_HEX_LOWER)
+                throw std::runtime_error("Unknown encoding in program");
+
+            program->_constants.push_back({read_string(position, end), encoding});
+        }
+
+        count = read_integer(position, end, 4);
+        for(size_t i = 0; i < count; ++i){
+            program->_field_names.push_back(read_string(position, end));
+            program->_fields.push_back(decoder::Frame::resolve_field(program->_field_names.back()));
+            if(program->_fields.back().kind == decoder::FIELD_NONE)
+                throw std::runtime_error("Unknown field " + program->_field_names.back() + " in program");
+        }
+
+        count = read_integer(position, end, 4);
+        for(size_t i = 0; i < count; ++i){
+            digest::Algorithm algorithm = (digest::Algorithm) read_integer(position, end, 1);
+            if(algorithm > digest::ALGORITHM_SIPHASH128)
+                throw std::runtime_error("Unknown hash algorithm in program");
+
+            program->_hashes.push_back({algorithm, read_string(position, end)});
+        }
+
+        count = read_integer(position, end, 4);
+        for(size_t i = 0; i < count; ++i){
+            Instruction instruction;
+            instruction.opcode = (Opcode) read_integer(position, end, 1);
+            instruction.destination = read_integer(position, end, 2);
+            instruction.first = read_integer(position, end, 2);
+            instruction.second = read_integer(position, end, 2);
+            instruction.third = read_integer(position, end, 2);
+            instruction.script = read_integer(position, end, 2);
+            instruction.line = read_integer(position, end, 4);
+            program->_code.push_back(instruction);
+        }
+
+        if(position != end)
+            throw std::runtime_error("Unexpected bytes after the program");
+
+        // The widths and the constants of the registers are given by the instructions writing them
+        program->_widths.assign(program->_register_count, WIDTH_UNKNOWN);
+        program->_register_constants.assign(program->_register_count, SIZE_MAX);
+
+        std::vector<bool> written(program->_register_count, false);
+        auto check_read = [&](uint16_t value){
+            if(value >= program->_register_count || !written[value])
+                throw std::runtime_error("A register is read before being written in program");
+        };
+        auto check_write = [&](uint16_t value, size_t width){
+            if(value >= program->_register_count || written[value])
+                throw std::runtime_error("A register is written twice in program");
+            written[value] = true;
+            program->_widths[value] = width;
+        };
+        auto check_hash = [&](uint16_t slot){
+            if(slot >= program->_hashes.size())
+                throw std::runtime_error("Unknown hash slot in program");
+        };
+
+        for(const Instruction &instruction : program->_code){
+            switch(instruction.opcode){
+            case OP_LOAD_CONST:
+                if(instruction.first >= program->_constants.size())
+                    throw std::runtime_error("Unknown constant in program");
+                check_write(instruction.destination, program->_constants[instruction.first].bytes.size());
+                program->_register_constants[instruction.destination] = instruction.first;
+                break;
+            case OP_LOAD_FIELD:
+                if(instruction.first >= program->_fields.size())
+                    throw std::runtime_error("Unknown field in program");
+                check_write(instruction.destination, decoder::Frame::get_field_width(program->_fields[instruction.first]));
+                break;
+            case OP_SLICE_BIT:
+            case OP_SLICE_BYTE:
+                check_read(instruction.first);
+                check_write(instruction.destination, instruction.opcode == OP_SLICE_BIT ? (instruction.third + 7) / 8 : instruction.third);
+                break;
+            case OP_HASH_BEGIN:
+                check_hash(instruction.first);
+                break;
+            case OP_HASH_UPDATE:
+                check_read(instruction.first);
+                check_hash(instruction.second);
+                break;
+            case OP_HASH_FINAL:
+                check_hash(instruction.first);
+                check_write(instruction.destination, digest::Hash::get_length(program->_hashes[instruction.first].algorithm));
+                break;
+            case OP_EMIT:
+                check_read(instruction.first);
+                if(instruction.second >= program->_output_count)
+                    throw std::runtime_error("Unknown output in program");
+                break;
+            default:
+                throw std::runtime_error("Unknown operation in program");
+            }
+        }
+    } catch(const std::exception &e){
+        delete program;
+        throw;
+    }
+
+    return program;
+}
+
+std::string Program::to_string() const {
+    return to_string(std::vector<std::string>());
+}
+
+std::string Program::to_string(const std::vector<std::string> &annotations) const {
+    std::string output = "";
+
+    for(size_t i = 0; i < _code.size(); ++i){
+        const Instruction &instruction = _code[i];
+        if(i < annotations.size())
+            output += annotations[i];
+
+        std::string destination = "r" + std::to_string(instruction.destination) + " = ";
+        std::string first = "r" + std::to_string(instruction.first);
+        std::string second = "r" + std::to_string(instruction.second);
+        std::string third = "r" + std::to_string(instruction.third);
+
+        switch(instruction.opcode){
+        case OP_LOAD_CONST:
+            if(_constants[instruction.first].encoding == ENCODING_TEXT)
+                output += destination + "const \"" + _constants[instruction.first].bytes + "\"\n";
+            else
+                output += destination + "const " + decoder::Big_number::from_buffer_inv((const uint8_t *) _constants[instruction.first].bytes.data(),
+                    _constants[instruction.first].bytes.size(), _constants[instruction.first].bytes.size()).hex_string() + "\n";
+            break;
+        case OP_LOAD_FIELD:
+            output += destination + "field " + _field_names[instruction.first] + "\n";
+            break;
+        case OP_SLICE_BIT:
+            output += destination + "slice_bit " + first + ", " + std::to_string(instruction.second) + ", " + std::to_string(instruction.third) + "\n";
+            break;
+        case OP_SLICE_BYTE:
+            output += destination + "slice_byte " + first + ", " + std::to_string(instruction.second) + ", " + std::to_string(instruction.third) + "\n";
+            break;
+        case OP_HASH_BEGIN:
+            output += "hash_begin h" + std::to_string(instruction.first) + " ";
+            output += digest::Hash::get_name(_hashes[instruction.first].algorithm);
+            output += "\n";
+            break;
+        case OP_HASH_UPDATE:
+            output += "hash_update h" + std::to_string(instruction.second) + ", " + first + (instruction.third ? " as text" : "") + "\n";
+            break;
+        case OP_HASH_FINAL:
+            output += destination + "hash_final h" + std::to_string(instruction.first) + "\n";
+            break;
+        case OP_EMIT:
+            output += "emit " + first + " to output " + std::to_string(instruction.second) + "\n";
+            break;
+        }
+    }
+
+    return output;
+}
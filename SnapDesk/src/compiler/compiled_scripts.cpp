@@ -0,0 +1,274 @@
+#include "compiler/compiled_scripts.hpp"
+
+#include <cstring>
+
+#include "database/core.hpp"
+
+using namespace compiler;
+
+/* Constructor */
+
+Compiled_scripts::Compiled_scripts(const std::vector<std::string> &scripts, bool is_profiling, bool is_cache_loaded) : _scripts(scripts), _is_profiling(is_profiling) {
+    if(_scripts.empty())
+        throw std::invalid_argument("No script given");
+
+    try{
+        for(const std::string &script : _scripts){
+            _communicators.push_back(new os_communicator::Communicator(script));
+            _compilers.push_back(new Compiler(_communicators.back()));
+            _filters.push_back(_compilers.back()->get_filters());
+            _hashes.push_back(_compilers.back()->get_hash());
+            _output_names.push_back(_compilers.back()->get_output_names());
+
+            // The Output blocks are columns of the databases, next to the ones written for every script
+            std::vector<std::string> column_names = COLUMN_NAMES;
+            for(const std::string &name : _output_names.back())
+                if(std::find(column_names.begin(), column_names.end(), name) != column_names.end())
+                    throw std::runtime_error(script + ": the Output " + name + " has the name of a column of the databases");
+        }
+
+        // The output of a script is followed by the ones of its Output blocks, as lowered by executable_tree::Root
+        size_t position = 0;
+        for(const std::vector<std::string> &names : _output_names){
+            _output_positions.push_back(position);
+            position += 1 + names.size();
+        }
+
+        // The program saved by a previous start is used as long as the scripts have the same hashes, the profile needs the trees
+        _cache_file_name = _scripts[0] + PROGRAM_CACHE_EXTENTION;
+        if(!_is_profiling && is_cache_loaded)
+            _program = bytecode::Program_cache::load(_cache_file_name, _hashes);
+        if(_program && _program->get_output_count() != position){
+            delete _program;
+            _program = nullptr;
+        }
+        _is_cached = _program != nullptr;
+
+        if(!_is_cached){
+            for(Compiler *compiler : _compilers)
+                _trees.push_back(compiler->get_executable_tree());
+
+            // The scripts share one program, the fields and the cuts they have in common are computed once
+            _program = Compiler::get_program(_trees);
+            if(is_cache_loaded)
+                bytecode::Program_cache::store(_cache_file_name, _hashes, _program);
+        }
+        _vm = new bytecode::Vm(_program);
+        _vm->set_profiling(_is_profiling);
+        _cache = new bytecode::Fingerprint_cache(_program);
+    } catch(const std::exception &e){
+        _clear();
+        throw;
+    }
+
+    // The script compiled in the binary is used only if it is the current one, and has no profile
+    _is_native = !_is_profiling && _program->get_output_count() == 1 && native::SCRIPT_HASH[0] != '\0' && _hashes[0] == native::SCRIPT_HASH;
+    _native_outputs.resize(1);
+    _is_accepted.resize(_scripts.size(), true);
+}
+
+Compiled_scripts::~Compiled_scripts() {
+    _clear();
+}
+
+/* Private */
+
+/**
+ * @brief Write the profile of an instruction or a node as the prefix of its line
+ * 
+ * @param profile the profile, nullptr if nothing was executed for the line
+ * @return std::string the prefix
+ */
+static std::string get_annotation(const bytecode::Instruction_profile *profile) {
+    char annotation[64];
+
+    if(!profile || profile->count == 0)
+        snprintf(annotation, sizeof(annotation), "%10s %14s %10s %12s | ", "", "", "", "");
+    else
+        snprintf(annotation, sizeof(annotation), "%10zu %14llu %10llu %12zu | ", profile->count, (unsigned long long) profile->ticks,
+            (unsigned long long) (profile->ticks / profile->count), profile->bytes);
+
+    return annotation;
+}
+
+void Compiled_scripts::_clear() {
+    delete _cache;
+    delete _vm;
+    delete _program;
+    for(const executable_tree::Node *tree : _trees)
+        delete tree;
+    for(const std::vector<Filter *> &filters : _filters)
+        for(Filter *filter : filters)
+            delete filter;
+    for(Compiler *compiler : _compilers)
+        delete compiler;
+    for(os_communicator::Communicator *communicator : _communicators)
+        delete communicator;
+
+    _cache = nullptr;
+    _vm = nullptr;
+    _program = nullptr;
+    _trees.clear();
+    _output_names.clear();
+    _output_positions.clear();
+    _filters.clear();
+    _compilers.clear();
+    _communicators.clear();
+}
+
+/* Public */
+
+bool Compiled_scripts::filter(const decoder::Frame *frame) {
+    bool is_kept = false;
+
+    // The blocks of a script stop at the first one skipping the frame, which counts it
+    for(size_t i = 0; i < _filters.size(); ++i){
+        _is_accepted[i] = true;
+        for(Filter *filter : _filters[i]){
+            if(!filter->accept(frame)){
+                _is_accepted[i] = false;
+                break;
+            }
+        }
+        is_kept |= _is_accepted[i];
+    }
+
+    return is_kept;
+}
+
+bool Compiled_scripts::is_cached() const {
+    return _is_cached;
+}
+
+bool Compiled_scripts::is_accepted(size_t script) const {
+    return _is_accepted.at(script);
+}
+
+const std::vector<std::string> &Compiled_scripts::run(const decoder::Frame *frame) {
+    // The beacons of an AP give the same outputs until a field read by the scripts changes
+    const std::vector<std::string> *outputs = _cache->find(frame);
+    if(outputs)
+        return *outputs;
+
+    if(_is_native){
+        native::run(frame, _native_outputs[0]);
+        outputs = &_native_outputs;
+    } else {
+        _vm->run(frame);
+        outputs = &_vm->get_outputs();
+    }
+    _cache->insert(*outputs);
+
+    return *outputs;
+}
+
+const std::vector<std::string> &Compiled_scripts::get_scripts() const {
+    return _scripts;
+}
+
+const std::vector<std::string> &Compiled_scripts::get_hashes() const {
+    return _hashes;
+}
+
+const std::vector<std::vector<std::string>> &Compiled_scripts::get_output_names() const {
+    return _output_names;
+}
+
+size_t Compiled_scripts::get_output_position(size_t script) const {
+    return _output_positions.at(script);
+}
+
+const bytecode::Fingerprint_cache *Compiled_scripts::get_cache() const {
+    return _cache;
+}
+
+void Compiled_scripts::print() const {
+    for(size_t i = 0; i < _scripts.size(); ++i){
+        printf("----- tree -----\n");
+        printf("%s (%s)\n", _scripts[i].c_str(), _hashes[i].c_str());
+        for(const Filter *filter : _filters[i])
+            printf("%s\n", filter->to_string().c_str());
+        if(_is_cached)
+            printf("Not built, the program is loaded from %s\n", _cache_file_name.c_str());
+        else
+            printf("%s", _trees[i]->to_string(0).c_str());
+        printf("----------------\n");
+    }
+
+    printf("--- program ----\n");
+    printf("%s", _program->to_string().c_str());
+    printf("----------------\n");
+
+    // The same field, cut or hash used in several places is computed once per frame
+    std::string shared = _program->get_shared_values();
+    if(!shared.empty()){
+        printf("---- shared ----\n");
+        printf("%s", shared.c_str());
+        printf("----------------\n");
+    }
+
+    if(_is_native)
+        printf("The script is run as native code\n");
+    else if(native::SCRIPT_HASH[0] != '\0')
+        printf("The native code was built for another script, the script is interpreted\n");
+}
+
+void Compiled_scripts::print_filters() const {
+    for(size_t i = 0; i < _scripts.size(); ++i){
+        if(_filters[i].empty())
+            continue;
+
+        printf("Filters of %s :\n", _scripts[i].c_str());
+        for(size_t j = 0; j < _filters[i].size(); ++j)
+            printf("%s%s: %zu skipped\n", j == _filters[i].size()-1 ? "└─" : "├─", _filters[i][j]->to_string().c_str(), _filters[i][j]->get_skipped());
+    }
+}
+
+void Compiled_scripts::print_profile() const {
+    if(!_is_profiling)
+        return;
+
+    const std::vector<bytecode::Instruction> &code = _program->get_code();
+    const std::vector<bytecode::Instruction_profile> &profile = _vm->get_profile();
+    std::string header = "     calls " + std::string(14 - strlen(PROFILE_TICK_UNIT), ' ') + PROFILE_TICK_UNIT + "   per call        bytes | ";
+
+    // The cost of a node is the one of the instructions it emitted, the bytes hashed are not produced by it
+    std::map<std::pair<uint16_t, uint32_t>, bytecode::Instruction_profile> nodes;
+    std::vector<std::string> annotations;
+    for(size_t i = 0; i < code.size(); ++i){
+        bytecode::Instruction_profile &node = nodes[{code[i].script, code[i].line}];
+        node.count = std::max(node.count, profile[i].count);
+        node.ticks += profile[i].ticks;
+        if(code[i].opcode != bytecode::OP_HASH_UPDATE)
+            node.bytes += profile[i].bytes;
+
+        annotations.push_back(get_annotation(&profile[i]));
+    }
+
+    for(size_t i = 0; i < _scripts.size(); ++i){
+        std::vector<size_t> lines;
+        _trees[i]->get_lines(lines);
+        std::string tree = _trees[i]->to_string(0);
+
+        printf("--- profile ----\n");
+        printf("%s\n", _scripts[i].c_str());
+        printf("%s\n", header.c_str());
+
+        size_t start = 0;
+        for(size_t line : lines){
+            size_t end = tree.find('\n', start);
+            if(end == std::string::npos)
+                end = tree.size();
+
+            auto node = nodes.find({(uint16_t) i, (uint32_t) line});
+            printf("%s%s\n", get_annotation(node == nodes.end() ? nullptr : &node->second).c_str(), tree.substr(start, end - start).c_str());
+
+            start = end + 1;
+        }
+    }
+
+    printf("--- program ----\n");
+    printf("%s\n", header.c_str());
+    printf("%s", _program->to_string(annotations).c_str());
+    printf("----------------\n");
+}
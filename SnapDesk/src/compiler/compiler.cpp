@@ -2,70 +2,443 @@
 
 using namespace compiler;
 
-size_t Compiler::read_line(executable_tree::Node *current_node, size_t next_line) const{
-    executable_tree::Node *new_node = nullptr;
-    executable_tree::Node *aux_function_node = nullptr;
-    while(!new_node){
-        std::string line = _communicator->get_line(next_line);
+/**
+ * @brief Create the node of a function
+ * 
+ * @param name the name of the function
+ * @return executable_tree::Node* the node, or nullptr if the function does not exist
+ */
+static executable_tree::Node *create_function(const std::string &name){
+    if(name == "Sha256")
+        return new executable_tree::Sha256();
+    if(name == "Sha256_raw")
+        return new executable_tree::Sha256_raw();
+    if(name == "Xxh64")
+        return new executable_tree::Xxh64();
+    if(name == "Xxh128")
+        return new executable_tree::Xxh128();
+    if(name == "Siphash64")
+        return new executable_tree::Siphash64();
+    if(name == "Siphash128")
+        return new executable_tree::Siphash128();
+    if(name == "Cut_bit")
+        return new executable_tree::Cut_bit();
+    if(name == "Cut_byte")
+        return new executable_tree::Cut_byte();
+    if(name == "Ie_order")
+        return new executable_tree::Ie_order();
+    if(name == "Ie_set")
+        return new executable_tree::Ie_set();
 
-        char first_char = line.front();
-        char last_char = line.back();
+    return nullptr;
+}
 
-        if(line == ""){
-            // end of file
-            break;
-        } else if (first_char == '#'){
-            next_line++;
-        } else if(first_char == '}' && line.size() == 1) {
-            // end of function
-            if(!aux_function_node)
-                throw runtime_error("End of function without begin it, line " + std::to_string(next_line+1));
-            new_node = aux_function_node;
-            aux_function_node = nullptr;
-            break;
-        } else if(aux_function_node) {
-            // if we are in the function
-            next_line = read_line(aux_function_node, next_line);
-        } else if(last_char == '{'){
-            // begin of function
-            if(line == "Sha256 {")
-                aux_function_node = new executable_tree::Sha256();
-            else if(line == "Cut_bit {")
-                aux_function_node = new executable_tree::Cut_bit();
-            else if(line == "Cut_byte {")
-                aux_function_node = new executable_tree::Cut_byte();
-            else
-                throw runtime_error("fonction " + line + " does not exist!");
-                        
-            next_line = read_line(aux_function_node, next_line+1);
-        } else if(first_char == '>'){
-            // Getter
-            line.erase(0, 1); // get rid of >
-            new_node = new executable_tree::Getter(line);
-            break;
-        } else {
-            // Value
-            new_node = new executable_tree::Value(line);
+/* Constructor */
+
+Compiler::Compiler(const os_communicator::Communicator *communicator) : _communicator(communicator) {
+    if(!_communicator)
+        throw invalid_argument("No communicator given");
+
+    // The only read of the source code, the tree and the hash both come from the tokens
+    _lexer = new Lexer(_communicator->get_content());
+};
+
+Compiler::~Compiler() {
+    delete _lexer;
+};
+
+/* Private */
+
+executable_tree::Node *Compiler::parse_node(size_t &position) const {
+    const std::vector<Token> &tokens = _lexer->get_tokens();
+    const Token &token = tokens[position];
+    executable_tree::Node *node = nullptr;
+
+    switch(token.kind){
+        case TOKEN_VALUE:
+            node = new executable_tree::Value(token.text);
+            node->set_line(token.line);
+            position++;
+            return node;
+        case TOKEN_GETTER:
+            node = new executable_tree::Getter(token.text);
+            node->set_line(token.line);
+            position++;
+            return node;
+        case TOKEN_END:
+            throw runtime_error("line " + std::to_string(token.line) + ": end of function without begin it");
+        case TOKEN_END_OF_SCRIPT:
+            throw runtime_error("line " + std::to_string(token.line) + ": end of script where a value is expected");
+        case TOKEN_BEGIN:
             break;
+    }
+
+    if(is_filter(token))
+        throw runtime_error("line " + std::to_string(token.line) + ": " + token.text + " must be at the beginning of the script");
+    if(is_output(token))
+        throw runtime_error("line " + std::to_string(token.line) + ": " + token.text + " must follow the result of the script");
+
+    node = create_function(token.text);
+    if(!node)
+        throw runtime_error("line " + std::to_string(token.line) + ": fonction " + token.text + " does not exist!");
+    node->set_line(token.line);
+    position++;
+
+    try{
+        while(tokens[position].kind != TOKEN_END){
+            if(tokens[position].kind == TOKEN_END_OF_SCRIPT)
+                throw runtime_error("line " + std::to_string(token.line) + ": function " + token.text + " begun but not ended");
+
+            node->add_node(parse_node(position));
         }
+    } catch(const std::exception &e){
+        delete node;
+        throw;
+    }
+    position++;
+
+    return node;
+};
+
+bool Compiler::is_filter(const Token &token) {
+    return token.kind == TOKEN_BEGIN && (token.text == "Filter" || token.text == "Require");
+};
+
+Filter *Compiler::parse_filter(size_t &position) const {
+    const std::vector<Token> &tokens = _lexer->get_tokens();
+    const Token &begin = tokens[position++];
+    std::string prefix = "line " + std::to_string(begin.line) + ": ";
+
+    // >field, then the test, then its operands
+    if(tokens[position].kind != TOKEN_GETTER)
+        throw runtime_error(prefix + begin.text + " must begin with the getter of its field");
+    const std::string &field = tokens[position++].text;
+
+    if(tokens[position].kind != TOKEN_VALUE)
+        throw runtime_error(prefix + begin.text + " must give a test after its field");
+    const std::string &predicate = tokens[position++].text;
+
+    std::vector<std::string> operands;
+    while(tokens[position].kind == TOKEN_VALUE)
+        operands.push_back(tokens[position++].text);
+
+    if(tokens[position].kind == TOKEN_END_OF_SCRIPT)
+        throw runtime_error(prefix + "function " + begin.text + " begun but not ended");
+    if(tokens[position].kind != TOKEN_END)
+        throw runtime_error("line " + std::to_string(tokens[position].line) + ": the operands of " + begin.text + " must be constants");
+    position++;
+
+    return new Filter(begin.text == "Require", field, predicate, operands, begin.line);
+};
+
+bool Compiler::is_output(const Token &token) {
+    return token.kind == TOKEN_BEGIN && token.text.compare(0, 7, "Output ") == 0;
+};
+
+executable_tree::Node *Compiler::parse_output(size_t &position) const {
+    const std::vector<Token> &tokens = _lexer->get_tokens();
+    const Token &begin = tokens[position++];
+    std::string prefix = "line " + std::to_string(begin.line) + ": ";
+    std::string name = begin.text.substr(7);
+
+    // The name is a column of the databases
+    if(name.empty() || name.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_") != std::string::npos)
+        throw runtime_error(prefix + "the name of an Output must be made of letters, digits and _, not \"" + name + "\"");
+
+    executable_tree::Output *output = new executable_tree::Output(name);
+    output->set_line(begin.line);
+
+    try{
+        if(tokens[position].kind == TOKEN_END)
+            throw runtime_error(prefix + "the Output " + name + " has no value");
+        if(tokens[position].kind == TOKEN_END_OF_SCRIPT)
+            throw runtime_error(prefix + "function " + begin.text + " begun but not ended");
+
+        output->add_node(parse_node(position));
+
+        if(tokens[position].kind == TOKEN_END_OF_SCRIPT)
+            throw runtime_error(prefix + "function " + begin.text + " begun but not ended");
+        if(tokens[position].kind != TOKEN_END)
+            throw runtime_error("line " + std::to_string(tokens[position].line) + ": the Output " + name + " has more than one value");
+    } catch(const std::exception &e){
+        delete output;
+        throw;
     }
-    if(aux_function_node)
-        throw runtime_error("Function beggined but not ended");
-    if(new_node)
-        current_node->add_node(new_node);
+    position++;
 
-    return next_line+1;
+    return output;
 };
 
+/* Public */
+
 executable_tree::Node *Compiler::get_executable_tree() const {
+    const std::vector<Token> &tokens = _lexer->get_tokens();
     executable_tree::Root *root_node = new executable_tree::Root();
+    size_t position = 0;
+
+    try{
+        // The blocks are given by get_filters(), they are only checked here
+        while(is_filter(tokens[position]))
+            delete parse_filter(position);
 
-    size_t next_line = read_line(root_node, 0);
+        if(tokens[position].kind != TOKEN_END_OF_SCRIPT)
+            root_node->add_node(parse_node(position));
 
-    // error if code remaining
-    std::string line = _communicator->get_line(next_line);
-    if(line != "")
-        throw runtime_error("Too much code, from line " + std::to_string(next_line+1) + " => " + line);
+        // The Output blocks follow the result, each one is an output of the tree
+        std::vector<std::string> names;
+        while(is_output(tokens[position])){
+            const Token &begin = tokens[position];
+            executable_tree::Output *output = static_cast<executable_tree::Output *>(parse_output(position));
+            root_node->add_node(output);
+
+            if(std::find(names.begin(), names.end(), output->get_name()) != names.end())
+                throw runtime_error("line " + std::to_string(begin.line) + ": the Output " + output->get_name() + " is already defined");
+            names.push_back(output->get_name());
+        }
+
+        // error if code remaining
+        if(is_filter(tokens[position]))
+            throw runtime_error("line " + std::to_string(tokens[position].line) + ": " + tokens[position].text + " must be at the beginning of the script");
+        if(tokens[position].kind != TOKEN_END_OF_SCRIPT)
+            throw runtime_error("Too much code, from line " + std::to_string(tokens[position].line) + " => " + tokens[position].text);
+    } catch(const std::exception &e){
+        delete root_node;
+        throw;
+    }
 
     return root_node;
-};
\ No newline at end of file
+};
+
+std::vector<Filter *> Compiler::get_filters() const {
+    const std::vector<Token> &tokens = _lexer->get_tokens();
+    std::vector<Filter *> filters;
+    size_t position = 0;
+
+    try{
+        while(is_filter(tokens[position]))
+            filters.push_back(parse_filter(position));
+    } catch(const std::exception &e){
+        for(Filter *filter : filters)
+            delete filter;
+        throw;
+    }
+
+    return filters;
+};
+
+std::vector<std::string> Compiler::get_output_names() const {
+    std::vector<std::string> names;
+
+    // An Output block anywhere else is rejected by get_executable_tree()
+    for(const Token &token : _lexer->get_tokens())
+        if(is_output(token))
+            names.push_back(token.text.substr(7));
+
+    return names;
+};
+
+bytecode::Program *Compiler::get_program(const executable_tree::Node *tree) const {
+    return get_program(std::vector<const executable_tree::Node *>{tree});
+};
+
+bytecode::Program *Compiler::get_program(const std::vector<const executable_tree::Node *> &trees) {
+    if(trees.empty())
+        throw invalid_argument("No tree given");
+
+    bytecode::Program *program = new bytecode::Program();
+
+    try{
+        for(size_t i = 0; i < trees.size(); ++i){
+            if(!trees[i])
+                throw invalid_argument("No tree given");
+
+            program->set_script((uint16_t) i);
+            trees[i]->lower(*program);
+        }
+        program->remove_unused();
+    } catch(const std::exception &e){
+        delete program;
+        throw;
+    }
+
+    return program;
+};
+std::string Compiler::get_hash() const {
+    return _lexer->get_hash();
+};
+
+/**
+ * @brief Write bytes as a C string literal, each byte escaped
+ * 
+ * @param bytes the bytes
+ * @return std::string the literal, with its quotes
+ */
+static std::string cpp_string(const std::string &bytes){
+    static const char DIGITS[] = "0123456789abcdef";
+    std::string output = "\"";
+
+    for(unsigned char byte : bytes){
+        output += "\\x";
+        output += DIGITS[byte >> 4];
+        output += DIGITS[byte & 0xF];
+    }
+
+    return output + "\"";
+}
+
+/**
+ * @brief Get the declaration of the object computing a hash in the generated code
+ * 
+ * @param slot the hash
+ * @param name the name of the object
+ * @return std::string the declaration
+ */
+static std::string cpp_hash_declaration(const bytecode::Hash_slot &slot, const std::string &name){
+    switch(slot.algorithm){
+    case digest::ALGORITHM_SHA256:
+        return "digest::Sha256 " + name + ";";
+    case digest::ALGORITHM_XXH64:
+        return "digest::Xxh64 " + name + ";";
+    case digest::ALGORITHM_XXH128:
+        return "digest::Xxh128 " + name + ";";
+    case digest::ALGORITHM_SIPHASH64:
+    case digest::ALGORITHM_SIPHASH128:
+        return "digest::Siphash " + name + "(std::string(" + cpp_string(slot.key) + ", " + std::to_string(slot.key.size()) + "), "
+            + std::to_string(digest::Hash::get_length(slot.algorithm)) + ");";
+    }
+
+    throw runtime_error("Unknown hash algorithm");
+}
+
+std::string Compiler::get_native_source(const bytecode::Program *program) const {
+    if(!program)
+        throw invalid_argument("No program given");
+    if(program->get_output_count() != 1)
+        throw invalid_argument("Only the program of a single script without Output block can be compiled to native code");
+
+    const std::vector<bytecode::Constant> &constants = program->get_constants();
+    const std::vector<decoder::Field> &fields = program->get_fields();
+    const std::vector<bytecode::Hash_slot> &hashes = program->get_hashes();
+
+    // The encoding of each register is known at compile time
+    std::vector<bytecode::Encoding> encodings(program->get_register_count(), bytecode::ENCODING_TEXT);
+
+    std::string output = "";
+    output += "// Generated by snapdesk-codegen, do not edit\n\n";
+    output += "#include \"compiler/native.hpp\"\n";
+    output += "#include \"digest/sha256.hpp\"\n";
+    output += "#include \"digest/xxh64.hpp\"\n";
+    output += "#include \"digest/siphash.hpp\"\n\n";
+    output += "const char native::SCRIPT_HASH[] = \"" + get_hash() + "\";\n\n";
+
+    for(size_t i = 0; i < constants.size(); ++i){
+        if(constants[i].bytes.empty())
+            continue;
+
+        output += "static const char CONSTANT_" + std::to_string(i) + "[] = " + cpp_string(constants[i].bytes) + ";\n";
+    }
+
+    output += "\nbool native::run(const decoder::Frame *frame, std::string &output){\n";
+
+    for(size_t i = 0; i < hashes.size(); ++i)
+        output += "    static thread_local " + cpp_hash_declaration(hashes[i], "h" + std::to_string(i)) + "\n";
+
+    output += "    decoder::Span span;\n";
+
+    // The listing of each instruction is written above its code
+    std::string listing = program->to_string();
+    size_t listing_position = 0;
+
+    for(const bytecode::Instruction &instruction : program->get_code()){
+        std::string destination = std::to_string(instruction.destination);
+        std::string first = std::to_string(instruction.first);
+        std::string source = "r" + first + ", n" + first;
+
+        size_t end = listing.find('\n', listing_position);
+        output += "\n    // " + listing.substr(listing_position, end - listing_position) + "\n";
+        listing_position = end + 1;
+
+        switch(instruction.opcode){
+        case bytecode::OP_LOAD_CONST: {
+            const bytecode::Constant &constant = constants[instruction.first];
+            encodings[instruction.destination] = constant.encoding;
+
+            if(constant.bytes.empty())
+                output += "    const uint8_t *r" + destination + " = nullptr;\n";
+            else
+                output += "    const uint8_t *r" + destination + " = (const uint8_t *) CONSTANT_" + first + ";\n";
+            output += "    size_t n" + destination + " = " + std::to_string(constant.bytes.size()) + ";\n";
+            break;
+        }
+        case bytecode::OP_LOAD_FIELD: {
+            const decoder::Field &field = fields[instruction.first];
+            encodings[instruction.destination] = bytecode::ENCODING_HEX_UPPER;
+
+            output += "    const uint8_t *r" + destination + " = nullptr;\n";
+            output += "    size_t n" + destination + " = 0;\n";
+            output += "    if(frame->get_field(decoder::Field{(decoder::Field_kind) " + std::to_string(field.kind) + ", "
+                + std::to_string(field.id) + "}, span)){\n";
+            output += "        r" + destination + " = span.data;\n";
+            output += "        n" + destination + " = span.size;\n";
+            output += "    }\n";
+            break;
+        }
+        case bytecode::OP_SLICE_BIT: {
+            std::string parameters = "<" + std::to_string(instruction.second) + ", " + std::to_string(instruction.third) + ">";
+            encodings[instruction.destination] = bytecode::ENCODING_HEX_UPPER;
+
+            output += "    uint8_t b" + destination + "[" + std::to_string((instruction.third + 7) / 8) + "];\n";
+            output += "    size_t n" + destination + " = native::slice_bit" + parameters + "(b" + destination + ", " + source + ");\n";
+            output += "    const uint8_t *r" + destination + " = n" + destination + " ? b" + destination + " : nullptr;\n";
+            break;
+        }
+        case bytecode::OP_SLICE_BYTE: {
+            std::string parameters = "<" + std::to_string(instruction.second) + ", " + std::to_string(instruction.third) + ">";
+            encodings[instruction.destination] = bytecode::ENCODING_HEX_UPPER;
+
+            output += "    const uint8_t *r" + destination + " = native::slice_byte" + parameters + "(" + source + ");\n";
+            output += "    size_t n" + destination + " = r" + destination + " ? " + std::to_string(instruction.third) + " : 0;\n";
+            break;
+        }
+        case bytecode::OP_HASH_BEGIN:
+            output += "    h" + first + ".begin();\n";
+            break;
+        case bytecode::OP_HASH_UPDATE: {
+            std::string hash = "h" + std::to_string(instruction.second);
+            bytecode::Encoding encoding = encodings[instruction.first];
+
+            if(!instruction.third || encoding == bytecode::ENCODING_TEXT)
+                output += "    " + hash + ".update(" + source + ");\n";
+            else
+                output += "    native::update_hex<" + std::string(encoding == bytecode::ENCODING_HEX_UPPER ? "true" : "false") + ">("
+                    + hash + ", " + source + ");\n";
+            break;
+        }
+        case bytecode::OP_HASH_FINAL: {
+            std::string length = std::to_string(digest::Hash::get_length(hashes[instruction.first].algorithm));
+            encodings[instruction.destination] = bytecode::ENCODING_HEX_LOWER;
+
+            output += "    uint8_t b" + destination + "[" + length + "];\n";
+            output += "    h" + first + ".final(b" + destination + ");\n";
+            output += "    const uint8_t *r" + destination + " = b" + destination + ";\n";
+            output += "    size_t n" + destination + " = " + length + ";\n";
+            break;
+        }
+        case bytecode::OP_EMIT: {
+            bytecode::Encoding encoding = encodings[instruction.first];
+
+            output += "    output.clear();\n";
+            if(encoding == bytecode::ENCODING_TEXT)
+                output += "    output.append((const char *) r" + first + ", n" + first + ");\n";
+            else
+                output += "    native::append_hex<" + std::string(encoding == bytecode::ENCODING_HEX_UPPER ? "true" : "false") + ">(output, "
+                    + source + ");\n";
+            break;
+        }
+        }
+    }
+
+    output += "\n    return true;\n}\n";
+
+    return output;
+};
@@ -0,0 +1,117 @@
+#include "compiler/filter.hpp"
+
+using namespace compiler;
+
+/* Constructor */
+
+Filter::Filter(bool is_require, const std::string &field_name, const std::string &predicate_name, const std::vector<std::string> &operands, size_t line)
+: _is_require(is_require), _field_name(field_name), _texts(operands), _line(line) {
+    std::string prefix = "line " + std::to_string(_line) + ": ";
+
+    _field = decoder::Frame::resolve_field(_field_name);
+    if(_field.kind == decoder::FIELD_NONE)
+        throw std::runtime_error(prefix + "the field " + _field_name + " does not exist");
+    if(!decoder::Frame::is_peekable(_field))
+        throw std::runtime_error(prefix + "the field " + _field_name + " cannot be tested before decoding, only the header, the fixed fields and the IEs can");
+    // A MAC address is written in the order of the frame, as 02:01:03:04:05:06, so that Prefix selects an OUI
+    bool is_address = _field.kind == decoder::FIELD_HEADER && _field.id >= decoder::HEADER_DESTINATION_ADDRESS && _field.id <= decoder::HEADER_ADDRESS_4;
+    _is_reversed = decoder::Frame::is_peek_reversed(_field) && !is_address;
+
+    if(predicate_name == "Equals")
+        _predicate = PREDICATE_EQUALS;
+    else if(predicate_name == "In")
+        _predicate = PREDICATE_IN;
+    else if(predicate_name == "Prefix")
+        _predicate = PREDICATE_PREFIX;
+    else if(predicate_name == "Exists")
+        _predicate = PREDICATE_EXISTS;
+    else
+        throw std::runtime_error(prefix + "the test " + predicate_name + " does not exist, it must be Equals, In, Prefix or Exists");
+
+    if(_predicate == PREDICATE_EQUALS && operands.size() != 1)
+        throw std::runtime_error(prefix + "Equals needs 1 operand");
+    if((_predicate == PREDICATE_IN || _predicate == PREDICATE_PREFIX) && operands.empty())
+        throw std::runtime_error(prefix + predicate_name + " needs at least 1 operand");
+    if(_predicate == PREDICATE_EXISTS && !operands.empty())
+        throw std::runtime_error(prefix + "Exists has no operand");
+
+    for(const std::string &operand : operands){
+        std::string bytes = operand;
+
+        // 0x0011 is the value 00 11, as a field written by a script, 0x alone is the empty value
+        if(operand.size() >= 2 && operand[0] == '0' && operand[1] == 'x'){
+            std::string digits = operand.substr(2);
+            if(digits.size() % 2 || digits.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+                throw std::runtime_error(prefix + "the operand " + operand + " must be an even number of hex digits after 0x");
+
+            bytes.clear();
+            for(size_t i = 0; i < digits.size(); i += 2)
+                bytes.push_back((char) std::stoul(digits.substr(i, 2), nullptr, 16));
+        }
+
+        // Compared to the raw bytes, so the frame is not reordered
+        if(_is_reversed)
+            std::reverse(bytes.begin(), bytes.end());
+
+        _operands.push_back(bytes);
+    }
+}
+
+/* Private */
+
+bool Filter::_match(const decoder::Span &span) const {
+    switch(_predicate){
+    case PREDICATE_EXISTS:
+        return true;
+    case PREDICATE_EQUALS:
+    case PREDICATE_IN:
+        for(const std::string &operand : _operands)
+            if(operand.size() == span.size && memcmp(operand.data(), span.data, span.size) == 0)
+                return true;
+        return false;
+    case PREDICATE_PREFIX:
+        // The beginning of a reversed value is the end of its raw bytes
+        for(const std::string &operand : _operands){
+            if(operand.size() > span.size)
+                continue;
+
+            const uint8_t *start = _is_reversed ? span.data + span.size - operand.size() : span.data;
+            if(memcmp(operand.data(), start, operand.size()) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    return false;
+}
+
+/* Public */
+
+bool Filter::accept(const decoder::Frame *frame) {
+    if(!frame)
+        throw std::invalid_argument("No frame given");
+
+    decoder::Span span;
+    bool is_matching = frame->peek_field(_field, span) && _match(span);
+
+    if(is_matching != _is_require){
+        _skipped++;
+        return false;
+    }
+
+    return true;
+}
+
+size_t Filter::get_skipped() const {
+    return _skipped;
+}
+
+std::string Filter::to_string() const {
+    static const char *PREDICATE_NAMES[] = {"Equals", "In", "Prefix", "Exists"};
+    std::string output = std::string(_is_require ? "Require" : "Filter") + " (line " + std::to_string(_line) + ") >" + _field_name + " " + PREDICATE_NAMES[_predicate];
+
+    for(const std::string &text : _texts)
+        output += " " + text;
+
+    return output;
+}
@@ -0,0 +1,97 @@
+#include "compiler/fingerprint_cache.hpp"
+
+using namespace bytecode;
+
+/* Constructor */
+
+Fingerprint_cache::Fingerprint_cache(const Program *program, size_t capacity) : _program(program), _capacity(capacity) {
+    if(!_program)
+        throw std::invalid_argument("No program given");
+    if(_capacity == 0)
+        throw std::invalid_argument("The capacity of the cache must not be 0");
+
+    _bssid = decoder::Frame::resolve_field("bssid");
+    _entries.reserve(_capacity);
+    _key.reserve(FRAME_MAX_LENGTH);
+    _is_cacheable = false;
+}
+
+/* Public */
+
+const std::vector<std::string> *Fingerprint_cache::find(const decoder::Frame *frame) {
+    if(!frame)
+        throw std::invalid_argument("No frame given");
+
+    decoder::Span span;
+
+    _is_cacheable = frame->get_field(_bssid, span) && span.size <= sizeof(_bssid_value);
+    if(!_is_cacheable){
+        _misses++;
+        return nullptr;
+    }
+
+    _bssid_value = 0;
+    for(size_t i = 0; i < span.size; ++i)
+        _bssid_value = (_bssid_value << 8) | span.data[i];
+
+    // Each field is written with its length, so that two frames never give the same key
+    _key.clear();
+    for(const decoder::Field &field : _program->get_fields()){
+        uint32_t size = 0;
+        if(frame->get_field(field, span))
+            size = (uint32_t) span.size;
+
+        _key.append((const char *) &size, sizeof(size));
+        if(size)
+            _key.append((const char *) span.data, size);
+    }
+
+    _hash.begin();
+    _hash.update(_key.data(), _key.size());
+    _digest = _hash.final_value();
+
+    auto entry = _entries.find(_bssid_value);
+    if(entry != _entries.end() && entry->second.digest == _digest && entry->second.key == _key){
+        _hits++;
+        return &entry->second.outputs;
+    }
+
+    _misses++;
+    return nullptr;
+}
+
+void Fingerprint_cache::insert(const std::vector<std::string> &outputs) {
+    if(!_is_cacheable)
+        return;
+
+    auto entry = _entries.find(_bssid_value);
+    if(entry == _entries.end()){
+        if(_entries.size() >= _capacity){
+            _entries.erase(_entries.begin());
+            _evictions++;
+        }
+        entry = _entries.emplace(_bssid_value, Entry()).first;
+    }
+
+    entry->second.digest = _digest;
+    entry->second.key = _key;
+    entry->second.outputs = outputs;
+}
+
+size_t Fingerprint_cache::get_hits() const {
+    return _hits;
+}
+
+size_t Fingerprint_cache::get_misses() const {
+    return _misses;
+}
+
+void Fingerprint_cache::print() const {
+    size_t total = _hits + _misses;
+
+    printf("Fingerprint cache :\n");
+    printf("├─hits------: %zu (%.1f%%)\n", _hits, total ? 100.0 * _hits / total : 0.0);
+    printf("├─misses----: %zu\n", _misses);
+    printf("├─bssids----: %zu / %zu\n", _entries.size(), _capacity);
+    printf("└─evictions-: %zu\n", _evictions);
+}
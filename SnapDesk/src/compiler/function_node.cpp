@@ -11,45 +11,77 @@ std::string Sha256::to_string(size_t depth) const {
     return output;
 };
 
-std::string Sha256::get_value(const decoder::Frame *target_frame) const {
-    Node::get_value(target_frame);
+uint16_t Sha256::lower(bytecode::Program &program) const {
+    return lower_hash(program, digest::ALGORITHM_SHA256, true);
+};
 
-    std::string data = "";
-    for(Node* arg : args){
-        data += arg->get_value(target_frame);
-    }
+std::string Sha256_raw::to_string(size_t depth) const {
+    std::string output = Node::to_string(depth);
+                
+    output += "SHA_RAW()\n";
+    output += Function::to_string(depth);
 
-    unsigned char hash[EVP_MAX_MD_SIZE];
-    unsigned int hash_len;
+    return output;
+};
 
-    EVP_MD_CTX* mdctx = EVP_MD_CTX_new();
-    if (mdctx == nullptr) {
-        throw std::runtime_error("Failed to create EVP_MD_CTX");
-    }
+uint16_t Sha256_raw::lower(bytecode::Program &program) const {
+    return lower_hash(program, digest::ALGORITHM_SHA256, false);
+};
 
-    if (EVP_DigestInit_ex(mdctx, EVP_sha256(), nullptr) != 1) {
-        EVP_MD_CTX_free(mdctx);
-        throw std::runtime_error("Failed to initialize digest");
-    }
+std::string Xxh64::to_string(size_t depth) const {
+    std::string output = Node::to_string(depth);
+                
+    output += "XXH64()\n";
+    output += Function::to_string(depth);
 
-    if (EVP_DigestUpdate(mdctx, data.c_str(), data.size()) != 1) {
-        EVP_MD_CTX_free(mdctx);
-        throw std::runtime_error("Failed to update digest");
-    }
+    return output;
+};
 
-    if (EVP_DigestFinal_ex(mdctx, hash, &hash_len) != 1) {
-        EVP_MD_CTX_free(mdctx);
-        throw std::runtime_error("Failed to finalize digest");
-    }
+uint16_t Xxh64::lower(bytecode::Program &program) const {
+    return lower_hash(program, digest::ALGORITHM_XXH64, false);
+};
 
-    std::string hash_string = "";
-    for(size_t i = 0; i < hash_len; ++i){
-        char buf[3];
-        snprintf(buf, sizeof(buf), "%02x", hash[i]);
-        hash_string += buf;
-    }
+std::string Xxh128::to_string(size_t depth) const {
+    std::string output = Node::to_string(depth);
+                
+    output += "XXH128()\n";
+    output += Function::to_string(depth);
+
+    return output;
+};
 
-    return hash_string;
+uint16_t Xxh128::lower(bytecode::Program &program) const {
+    return lower_hash(program, digest::ALGORITHM_XXH128, false);
+};
+
+std::string Siphash64::to_string(size_t depth) const {
+    std::string output = Node::to_string(depth);
+                
+    output += "SIPHASH64()\n";
+    output += Function::to_string(depth);
+
+    return output;
+};
+
+uint16_t Siphash64::lower(bytecode::Program &program) const {
+    std::string key = get_bytes(0, digest::Hash::get_key_length(digest::ALGORITHM_SIPHASH64), "key of Siphash64");
+
+    return lower_hash(program, digest::ALGORITHM_SIPHASH64, false, key, 1);
+};
+
+std::string Siphash128::to_string(size_t depth) const {
+    std::string output = Node::to_string(depth);
+                
+    output += "SIPHASH128()\n";
+    output += Function::to_string(depth);
+
+    return output;
+};
+
+uint16_t Siphash128::lower(bytecode::Program &program) const {
+    std::string key = get_bytes(0, digest::Hash::get_key_length(digest::ALGORITHM_SIPHASH128), "key of Siphash128");
+
+    return lower_hash(program, digest::ALGORITHM_SIPHASH128, false, key, 1);
 };
 
 std::string Cut_bit::to_string(size_t depth) const {
@@ -61,43 +93,33 @@ std::string Cut_bit::to_string(size_t depth) const {
     return output;
 };
 
-std::string Cut_bit::get_value(const decoder::Frame *target_frame) const {
-    Node::get_value(target_frame);
-
-    decoder::Big_number value = decoder::Big_number::null();
-    size_t first_bit;
-    size_t cut_length;
-
-    size_t i = 0;
-    for(Node* arg : args){
-        std::string arg_value = arg->get_value(target_frame);
-
-        switch (i){
-        case 0:
-            value = decoder::Big_number::from_hex_string(arg_value);
-            break;
-        case 1:
-            first_bit = std::stoul(arg_value);
-            break;
-        case 2:
-            cut_length = std::stoul(arg_value);
-            break;
-        default:
-            throw runtime_error("Too many args in Cut_bit");
-        }
-
-        ++i;
-    }
+uint16_t Cut_bit::lower(bytecode::Program &program) const {
+    check_arity(3, "Cut_bit");
+
+    size_t first_bit = get_integer(1, MAX_CUT_BITS, "first bit of Cut_bit");
+    size_t cut_length = get_integer(2, MAX_CUT_BITS, "length of Cut_bit");
+
+    if(cut_length == 0)
+        throw_error("the length of Cut_bit must not be 0");
+    if(first_bit + cut_length > MAX_CUT_BITS)
+        throw_error("Cut_bit is out of range of any frame");
+
+    uint16_t source = lower_binary(program, 0, "value of Cut_bit");
 
-    if(i < 3)
-        throw runtime_error("Too few args in Cut_bit");
+    size_t width = program.get_width(source);
+    if(width != WIDTH_UNKNOWN && first_bit + cut_length > width*8)
+        throw_error("Cut_bit is out of range of its " + std::to_string(width*8) + " bits value");
 
-    if(!value.is_null())
+    // A constant is cut once, at compile time
+    const bytecode::Constant *constant = program.get_constant(source);
+    if(constant){
+        decoder::Big_number value = decoder::Big_number::from_buffer_inv((const uint8_t *) constant->bytes.data(), constant->bytes.size(), constant->bytes.size());
         value.cut_bit(first_bit, cut_length);
-    else
-        return "";
 
-    return value.hex_string();
+        return program.load_constant(std::string((const char *) value.data(), value.size()), bytecode::ENCODING_HEX_UPPER);
+    }
+
+    return program.slice(bytecode::OP_SLICE_BIT, source, first_bit, cut_length);
 };
 
 std::string Cut_byte::to_string(size_t depth) const {
@@ -109,41 +131,61 @@ std::string Cut_byte::to_string(size_t depth) const {
     return output;
 };
 
-std::string Cut_byte::get_value(const decoder::Frame *target_frame) const {
-    Node::get_value(target_frame);
-
-    decoder::Big_number value = decoder::Big_number::null();
-    size_t first_byte;
-    size_t cut_length;
-
-    size_t i = 0;
-    for(Node* arg : args){
-        std::string arg_value = arg->get_value(target_frame);
-
-        switch (i){
-        case 0:
-            value = decoder::Big_number::from_hex_string(arg_value);
-            break;
-        case 1:
-            first_byte = std::stoul(arg_value);
-            break;
-        case 2:
-            cut_length = std::stoul(arg_value);
-            break;
-        default:
-            throw runtime_error("Too many args in Cut_byte");
-        }
-
-        ++i;
-    }
+uint16_t Cut_byte::lower(bytecode::Program &program) const {
+    check_arity(3, "Cut_byte");
+
+    size_t first_byte = get_integer(1, MAX_CUT_BITS / 8, "first byte of Cut_byte");
+    size_t cut_length = get_integer(2, MAX_CUT_BITS / 8, "length of Cut_byte");
+
+    if(cut_length == 0)
+        throw_error("the length of Cut_byte must not be 0");
+    if(first_byte + cut_length > MAX_CUT_BITS / 8)
+        throw_error("Cut_byte is out of range of any frame");
 
-    if(i < 3)
-        throw runtime_error("Too few args in Cut_byte");
+    uint16_t source = lower_binary(program, 0, "value of Cut_byte");
 
-    if(!value.is_null())
+    size_t width = program.get_width(source);
+    if(width != WIDTH_UNKNOWN && first_byte + cut_length > width)
+        throw_error("Cut_byte is out of range of its " + std::to_string(width) + " bytes value");
+
+    // A constant is cut once, at compile time
+    const bytecode::Constant *constant = program.get_constant(source);
+    if(constant){
+        decoder::Big_number value = decoder::Big_number::from_buffer_inv((const uint8_t *) constant->bytes.data(), constant->bytes.size(), constant->bytes.size());
         value.cut_byte(first_byte, cut_length);
-    else
-        return "";
 
-    return value.hex_string();
+        return program.load_constant(std::string((const char *) value.data(), value.size()), bytecode::ENCODING_HEX_UPPER);
+    }
+
+    return program.slice(bytecode::OP_SLICE_BYTE, source, first_byte, cut_length);
+};
+
+std::string Ie_order::to_string(size_t depth) const {
+    std::string output = Node::to_string(depth);
+                
+    output += "Ie_order()\n";
+    output += Function::to_string(depth);
+
+    return output;
+};
+
+uint16_t Ie_order::lower(bytecode::Program &program) const {
+    check_arity(0, "Ie_order");
+
+    return program.load_field("ie_order");
+};
+
+std::string Ie_set::to_string(size_t depth) const {
+    std::string output = Node::to_string(depth);
+                
+    output += "Ie_set()\n";
+    output += Function::to_string(depth);
+
+    return output;
+};
+
+uint16_t Ie_set::lower(bytecode::Program &program) const {
+    check_arity(0, "Ie_set");
+
+    return program.load_field("ie_set");
 };
\ No newline at end of file
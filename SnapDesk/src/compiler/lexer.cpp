@@ -0,0 +1,57 @@
+#include "compiler/lexer.hpp"
+
+using namespace compiler;
+
+/* Constructor */
+
+Lexer::Lexer(const std::string &source) {
+    digest::Sha256 &sha256 = digest::Sha256::get_thread_instance();
+    sha256.begin();
+
+    size_t line = 1;
+    size_t start = 0;
+
+    while(start < source.size()){
+        size_t end = source.find('\n', start);
+        if(end == std::string::npos)
+            end = source.size();
+
+        const char *text = source.data() + start;
+        size_t size = end - start;
+        start = end + 1;
+
+        if(size == 0)
+            break;
+
+        sha256.update(text, size);
+
+        if(text[0] == '#'){
+            // Comment
+        } else if(size == 1 && text[0] == '}'){
+            _tokens.push_back({TOKEN_END, "}", line});
+        } else if(text[size-1] == '{'){
+            if(size < 3 || text[size-2] != ' ')
+                throw std::runtime_error("line " + std::to_string(line) + ": a function begins with \"<name> {\", not " + std::string(text, size));
+            _tokens.push_back({TOKEN_BEGIN, std::string(text, size-2), line});
+        } else if(text[0] == '>'){
+            _tokens.push_back({TOKEN_GETTER, std::string(text+1, size-1), line});
+        } else {
+            _tokens.push_back({TOKEN_VALUE, std::string(text, size), line});
+        }
+
+        line++;
+    }
+
+    _tokens.push_back({TOKEN_END_OF_SCRIPT, "", line});
+    _hash = sha256.hex_final();
+}
+
+/* Public */
+
+const std::vector<Token> &Lexer::get_tokens() const {
+    return _tokens;
+}
+
+const std::string &Lexer::get_hash() const {
+    return _hash;
+}
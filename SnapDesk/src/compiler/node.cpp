@@ -4,19 +4,34 @@ using namespace executable_tree;
 
 /* Node */
 
-std::string Node::get_value(const decoder::Frame *target_frame) const {
-    if(!target_frame)
-        throw invalid_argument("No frame given");
-    if(!target_frame->get_is_decoded())
-        throw invalid_argument("Given frame is not decoded");
-                
-    return "";
+uint16_t Node::lower(bytecode::Program &program) const {
+    throw runtime_error("This type of node cannot be executed");
+};
+
+uint16_t Node::lower_at_line(bytecode::Program &program) const {
+    uint32_t previous = program.set_line((uint32_t) _line);
+    uint16_t value = lower(program);
+    program.set_line(previous);
+
+    return value;
+};
+
+void Node::set_line(size_t line) {
+    _line = line;
+};
+
+void Node::throw_error(const std::string &message) const {
+    throw runtime_error("line " + std::to_string(_line) + ": " + message);
 };
 
 void Node::add_node(Node* arg) {
     throw runtime_error("This type of node cannot have children");
 };
 
+void Node::get_lines(std::vector<size_t> &lines) const {
+    lines.push_back(_line);
+};
+
 std::string Node::to_string(size_t depth) const {
     std::string output = "";
 
@@ -28,23 +43,16 @@ std::string Node::to_string(size_t depth) const {
 
 /* Root */
 
-std::string Root::get_value(const decoder::Frame *target_frame) const {
-    Node::get_value(target_frame);
-
+uint16_t Root::lower(bytecode::Program &program) const {
     if(!_first_node)
         throw runtime_error("No tree");
 
-    std::string value;
+    uint16_t value = _first_node->lower_at_line(program);
 
-    try{
-        value = _first_node->get_value(target_frame);
-    }
-    catch(const std::exception& e){
-        std::string message = "Runtime error in code: ";
-        message += e.what();
-        throw runtime_error(message);
-    }
-    
+    program.emit(bytecode::OP_EMIT, value, value, program.add_output());
+
+    for(Node* output : _outputs)
+        output->lower_at_line(program);
 
     return value;
 };
@@ -52,18 +60,83 @@ std::string Root::get_value(const decoder::Frame *target_frame) const {
 void Root::add_node(Node* arg) {
     if(!arg)
         throw invalid_argument("no arg given");
-                
+
+    // The Output nodes come after the result
+    if(_first_node && dynamic_cast<Output*>(arg)){
+        _outputs.push_back(arg);
+        return;
+    }
+
     if(_first_node)
         throw runtime_error("root node had already a child");
 
     _first_node = arg;
 }
 
-std::string Root::to_string(size_t depth) const {
+void Root::get_lines(std::vector<size_t> &lines) const {
     if(_first_node)
-        return _first_node->to_string(depth);
-                
-    return "No tree";
+        _first_node->get_lines(lines);
+    else
+        lines.push_back(0);
+
+    for(Node* output : _outputs)
+        output->get_lines(lines);
+};
+
+std::string Root::to_string(size_t depth) const {
+    if(!_first_node)
+        return "No tree";
+
+    std::string output = _first_node->to_string(depth);
+
+    for(Node* node : _outputs)
+        output += node->to_string(depth);
+
+    return output;
+};
+
+/* Output */
+
+const std::string &Output::get_name() const {
+    return _name;
+};
+
+uint16_t Output::lower(bytecode::Program &program) const {
+    if(!_value)
+        throw_error("the Output " + _name + " has no value");
+
+    uint16_t value = _value->lower_at_line(program);
+
+    program.emit(bytecode::OP_EMIT, value, value, program.add_output());
+
+    return value;
+};
+
+void Output::add_node(Node* arg) {
+    if(!arg)
+        throw invalid_argument("no arg given");
+
+    if(_value)
+        throw_error("the Output " + _name + " has more than one value");
+
+    _value = arg;
+};
+
+void Output::get_lines(std::vector<size_t> &lines) const {
+    lines.push_back(_line);
+    if(_value)
+        _value->get_lines(lines);
+};
+
+std::string Output::to_string(size_t depth) const {
+    std::string output = Node::to_string(depth);
+
+    output += "Output -> " + _name + "\n";
+
+    if(_value)
+        output += _value->to_string(depth+1);
+
+    return output;
 };
 
 /* Function */
@@ -75,6 +148,78 @@ void Function::add_node(Node* arg) {
     args.push_back(arg);
 }
 
+uint16_t Function::lower_hash(bytecode::Program &program, digest::Algorithm algorithm, bool as_text, const std::string &key, size_t first) const {
+    size_t begin = program.get_code().size();
+    uint16_t slot = program.add_hash(algorithm, key);
+
+    program.emit(bytecode::OP_HASH_BEGIN, 0, slot);
+    for(size_t i = first; i < args.size(); ++i)
+        program.emit(bytecode::OP_HASH_UPDATE, 0, args[i]->lower_at_line(program), slot, as_text);
+
+    // The same hash of the same arguments is computed once per frame
+    return program.final_hash(slot, begin);
+}
+
+void Function::check_arity(size_t count, const std::string &name) const {
+    if(args.size() > count)
+        throw_error("Too many args in " + name + ", " + std::to_string(count) + " expected");
+    if(args.size() < count)
+        throw_error("Too few args in " + name + ", " + std::to_string(count) + " expected");
+}
+
+size_t Function::get_integer(size_t index, size_t max, const std::string &what) const {
+    const Value *value = dynamic_cast<const Value *>(args[index]);
+    if(!value)
+        throw_error("the " + what + " must be a constant");
+
+    const std::string &text = value->get_constant();
+    if(text.empty() || text.size() > 9 || text.find_first_not_of("0123456789") != std::string::npos)
+        throw_error("the " + what + " must be a decimal number, not " + text);
+
+    size_t number = std::stoul(text);
+    if(number > max)
+        throw_error("the " + what + " must be at most " + std::to_string(max) + ", not " + text);
+
+    return number;
+}
+
+std::string Function::get_bytes(size_t index, size_t length, const std::string &what) const {
+    const Value *value = args.size() > index ? dynamic_cast<const Value *>(args[index]) : nullptr;
+    if(!value)
+        throw_error("the " + what + " must be a constant");
+
+    const std::string &text = value->get_constant();
+    if(text.size() != 2*length || text.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+        throw_error("the " + what + " must be " + std::to_string(2*length) + " hex digits, not " + text);
+
+    std::string bytes(length, '\0');
+    for(size_t i = 0; i < length; ++i)
+        bytes[i] = (char) std::stoul(text.substr(2*i, 2), nullptr, 16);
+
+    return bytes;
+}
+
+uint16_t Function::lower_binary(bytecode::Program &program, size_t index, const std::string &what) const {
+    uint16_t value = args[index]->lower_at_line(program);
+
+    const bytecode::Constant *constant = program.get_constant(value);
+    if(!constant || constant->encoding != bytecode::ENCODING_TEXT)
+        return value;
+
+    if(constant->bytes.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+        throw_error("the " + what + " must be a field or a hex number, not " + constant->bytes);
+
+    decoder::Big_number number = decoder::Big_number::from_hex_string(constant->bytes);
+
+    return program.load_constant(std::string((const char *) number.data(), number.size()), bytecode::ENCODING_HEX_UPPER);
+}
+
+void Function::get_lines(std::vector<size_t> &lines) const {
+    lines.push_back(_line);
+    for(Node* arg : args)
+        arg->get_lines(lines);
+};
+
 std::string Function::to_string(size_t depth) const {
     std::string output = "";
 
@@ -86,8 +231,11 @@ std::string Function::to_string(size_t depth) const {
 
 /* Value */
 
-std::string Value::get_value(const decoder::Frame *target_frame) const {
-    Node::get_value(target_frame);
+uint16_t Value::lower(bytecode::Program &program) const {
+    return program.load_constant(value, bytecode::ENCODING_TEXT);
+};
+
+const std::string &Value::get_constant() const {
     return value;
 };
 
@@ -105,17 +253,12 @@ std::string Value::to_string(size_t depth) const {
 
 /* Getter */
 
-std::string Getter::get_value(const decoder::Frame *target_frame) const {
-    Node::get_value(target_frame);
-
-    decoder::Big_number value;
-
-    value = target_frame->get_value(field_name);
-                
-    if(value.is_null())
-        return "";
-                
-    return value.hex_string();
+uint16_t Getter::lower(bytecode::Program &program) const {
+    try{
+        return program.load_field(field_name);
+    } catch(const std::logic_error &e){
+        throw_error("cannot read the field \"" + field_name + "\"");
+    }
 };    
 
 void Getter::add_node(Node* arg) {
@@ -0,0 +1,110 @@
+#include "compiler/program_cache.hpp"
+
+using namespace bytecode;
+
+/**
+ * @brief Get the checksum of the bytes of a program
+ * 
+ * @param data the bytes of the program
+ * @param size the number of bytes
+ * @return uint64_t the XXH64 of the bytes
+ */
+static uint64_t get_checksum(const void *data, size_t size){
+    digest::Xxh64 xxh64;
+    xxh64.begin();
+    xxh64.update(data, size);
+
+    return xxh64.final_value();
+}
+
+/* Public */
+
+Program *Program_cache::load(const std::string &file_name, const std::vector<std::string> &hashes) {
+    int file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+    if(file_descriptor < 0)
+        return nullptr;
+
+    struct stat status;
+    if(fstat(file_descriptor, &status) != 0 || (size_t) status.st_size < sizeof(Program_cache_header)){
+        close(file_descriptor);
+        return nullptr;
+    }
+
+    size_t mapped_size = status.st_size;
+    void *mapping = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);
+    if(mapping == MAP_FAILED)
+        return nullptr;
+
+    const Program_cache_header *header = (const Program_cache_header *) mapping;
+    const char *stored_hashes = (const char *) mapping + sizeof(Program_cache_header);
+    size_t hashes_size = hashes.size() * PROGRAM_CACHE_HASH_LENGTH;
+
+    // The sizes are bounded by the mapping before being added, so that a huge program size cannot wrap the sum
+    bool is_valid = memcmp(header->magic, PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC)) == 0
+        && header->version == PROGRAM_CACHE_VERSION
+        && header->script_count == hashes.size()
+        && hashes_size <= mapped_size - sizeof(Program_cache_header)
+        && header->program_size <= mapped_size - sizeof(Program_cache_header) - hashes_size
+        && mapped_size == sizeof(Program_cache_header) + hashes_size + header->program_size;
+
+    for(size_t i = 0; is_valid && i < hashes.size(); ++i)
+        is_valid = hashes[i].size() == PROGRAM_CACHE_HASH_LENGTH
+            && memcmp(stored_hashes + i * PROGRAM_CACHE_HASH_LENGTH, hashes[i].data(), PROGRAM_CACHE_HASH_LENGTH) == 0;
+
+    const uint8_t *bytes = (const uint8_t *) stored_hashes + hashes_size;
+    is_valid = is_valid && get_checksum(bytes, header->program_size) == header->program_checksum;
+
+    Program *program = nullptr;
+    if(is_valid){
+        // A damaged program is compiled again, as a missing one
+        try{
+            program = Program::deserialize(bytes, header->program_size);
+        } catch(const std::exception &e){
+            program = nullptr;
+        }
+    }
+
+    munmap(mapping, mapped_size);
+
+    return program;
+}
+
+bool Program_cache::store(const std::string &file_name, const std::vector<std::string> &hashes, const Program *program) {
+    if(!program)
+        throw std::invalid_argument("No program given");
+
+    std::string bytes = program->serialize();
+
+    Program_cache_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PROGRAM_CACHE_MAGIC, sizeof(PROGRAM_CACHE_MAGIC));
+    header.version = PROGRAM_CACHE_VERSION;
+    header.script_count = hashes.size();
+    header.program_size = bytes.size();
+    header.program_checksum = get_checksum(bytes.data(), bytes.size());
+
+    std::string content((const char *) &header, sizeof(header));
+    for(const std::string &hash : hashes){
+        if(hash.size() != PROGRAM_CACHE_HASH_LENGTH)
+            throw std::invalid_argument("The hash " + hash + " is not the one of a script");
+        content += hash;
+    }
+    content += bytes;
+
+    // Another process starting on the same scripts reads the old file or the new one, never a part of it
+    std::string temporary_name = file_name + "." + std::to_string(getpid()) + ".tmp";
+    int file_descriptor = ::open(temporary_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(file_descriptor < 0)
+        return false;
+
+    bool is_written = ::write(file_descriptor, content.data(), content.size()) == (ssize_t) content.size();
+    close(file_descriptor);
+
+    if(!is_written || rename(temporary_name.c_str(), file_name.c_str()) != 0){
+        unlink(temporary_name.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,454 @@
+#include "compiler/vm.hpp"
+
+using namespace bytecode;
+
+static const char HEX_UPPER[] = "0123456789ABCDEF";
+static const char HEX_LOWER[] = "0123456789abcdef";
+
+/* Constructor */
+
+Vm::Vm(const Program *program) : _program(program) {
+    if(!_program)
+        throw std::invalid_argument("No program given");
+
+    _registers.resize(_program->get_register_count());
+    for(Register &current_register : _registers){
+        current_register.data = nullptr;
+        current_register.size = 0;
+        current_register.bit_length = 0;
+        current_register.encoding = ENCODING_TEXT;
+        current_register.storage.reserve(FRAME_MAX_LENGTH);
+    }
+
+    _outputs.resize(_program->get_output_count());
+    for(std::string &output : _outputs)
+        output.reserve(2*FRAME_MAX_LENGTH);
+    _emitted.resize(_program->get_output_count());
+
+    for(const Hash_slot &slot : _program->get_hashes())
+        _hashes.push_back(digest::Hash::create(slot.algorithm, slot.key));
+
+    _profile.resize(_program->get_code().size());
+}
+
+Vm::~Vm() {
+    for(digest::Hash *hash : _hashes)
+        delete hash;
+    for(digest::Hash *hash : _batch_hashes)
+        delete hash;
+}
+
+/* Private */
+
+template<typename Buffer>
+void Vm::_append_text(Buffer &output, const Register &value) {
+    if(value.encoding == ENCODING_TEXT){
+        output.insert(output.end(), value.data, value.data + value.size);
+        return;
+    }
+
+    const char *digits = value.encoding == ENCODING_HEX_UPPER ? HEX_UPPER : HEX_LOWER;
+
+    for(size_t i = 0; i < value.size; ++i){
+        output.push_back(digits[value.data[i] >> 4]);
+        output.push_back(digits[value.data[i] & 0xF]);
+    }
+}
+
+void Vm::_slice_bit(Register &destination, const Register &source, size_t from, size_t size) {
+    size_t number_size = source.size;
+    const uint8_t *number = source.data;
+
+    destination.encoding = ENCODING_HEX_UPPER;
+
+    // A null value or a value too short gives a null output
+    if(number_size == 0 || from + size > number_size*8){
+        destination.data = nullptr;
+        destination.size = 0;
+        destination.bit_length = 0;
+        return;
+    }
+
+    // The bits are counted from the least significant one, the result is on the smallest number of bytes
+    size_t output_size = (size + 7) / 8;
+    destination.storage.resize(output_size);
+
+    for(size_t i = 0; i < output_size; ++i){
+        size_t bit = from + 8*i;
+        size_t byte = bit / 8;
+        size_t shift = bit % 8;
+
+        unsigned value = number[number_size-1-byte] >> shift;
+        if(shift && byte+1 < number_size)
+            value |= number[number_size-2-byte] << (8 - shift);
+
+        size_t remaining = size - 8*i;
+        if(remaining < 8)
+            value &= (1u << remaining) - 1;
+
+        destination.storage[output_size-1-i] = (uint8_t) value;
+    }
+
+    destination.data = destination.storage.data();
+    destination.size = output_size;
+    destination.bit_length = size;
+}
+
+void Vm::_slice_byte(Register &destination, const Register &source, size_t from, size_t size) {
+    destination.encoding = ENCODING_HEX_UPPER;
+
+    // A null value or a value too short gives a null output
+    if(source.size == 0 || from + size > source.size){
+        destination.data = nullptr;
+        destination.size = 0;
+        destination.bit_length = 0;
+        return;
+    }
+
+    // The bytes are counted from the end, the source stays valid for the whole run
+    destination.data = source.data + source.size - (from + size);
+    destination.size = size;
+    destination.bit_length = 8*size;
+}
+
+void Vm::_update_text(digest::Hash &hash, const Register &value) {
+    if(value.encoding == ENCODING_TEXT){
+        hash.update(value.data, value.size);
+        return;
+    }
+
+    const char *digits = value.encoding == ENCODING_HEX_UPPER ? HEX_UPPER : HEX_LOWER;
+    char chunk[256];
+
+    for(size_t i = 0; i < value.size; i += sizeof(chunk)/2){
+        size_t count = std::min(value.size - i, sizeof(chunk)/2);
+
+        for(size_t j = 0; j < count; ++j){
+            chunk[2*j] = digits[value.data[i+j] >> 4];
+            chunk[2*j+1] = digits[value.data[i+j] & 0xF];
+        }
+        hash.update(chunk, 2*count);
+    }
+}
+
+void Vm::_reserve_batch(size_t count) {
+    if(count <= _batch_capacity)
+        return;
+
+    // The columns are laid out again for the new capacity, the storage of the digests is allocated by the first runs
+    for(digest::Hash *hash : _batch_hashes)
+        delete hash;
+    _batch_hashes.clear();
+
+    _batch_registers.assign(_program->get_register_count() * count, Register{nullptr, 0, 0, ENCODING_TEXT, {}});
+    for(const Hash_slot &slot : _program->get_hashes())
+        for(size_t i = 0; i < count; ++i)
+            _batch_hashes.push_back(digest::Hash::create(slot.algorithm, slot.key));
+    _batch_messages.assign(_program->get_hashes().size() * count, std::string());
+    _batch_message_data.resize(count);
+    _batch_message_sizes.resize(count);
+    _batch_digests.resize(count * SHA256_LENGTH);
+
+    _batch_capacity = count;
+}
+
+uint64_t Vm::_read_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+#endif
+}
+
+template<bool PROFILE>
+void Vm::_execute(const decoder::Frame *target_frame) {
+    const std::vector<Instruction> &code = _program->get_code();
+    const std::vector<decoder::Field> &fields = _program->get_fields();
+    const std::vector<Constant> &constants = _program->get_constants();
+
+    for(size_t i = 0; i < code.size(); ++i){
+        const Instruction &instruction = code[i];
+        Register &destination = _registers[instruction.destination];
+        uint64_t start = 0;
+        if constexpr (PROFILE)
+            start = _read_ticks();
+
+        switch(instruction.opcode){
+        case OP_LOAD_CONST: {
+            const Constant &constant = constants[instruction.first];
+            destination.data = (const uint8_t *) constant.bytes.data();
+            destination.size = constant.bytes.size();
+            destination.bit_length = 8*constant.bytes.size();
+            destination.encoding = constant.encoding;
+            break;
+        }
+        case OP_LOAD_FIELD: {
+            decoder::Span span;
+            if(!target_frame->get_field(fields[instruction.first], span)){
+                span.data = nullptr;
+                span.size = 0;
+            }
+            destination.data = span.data;
+            destination.size = span.size;
+            destination.bit_length = 8*span.size;
+            destination.encoding = ENCODING_HEX_UPPER;
+            break;
+        }
+        case OP_SLICE_BIT:
+            _slice_bit(destination, _registers[instruction.first], instruction.second, instruction.third);
+            break;
+        case OP_SLICE_BYTE:
+            _slice_byte(destination, _registers[instruction.first], instruction.second, instruction.third);
+            break;
+        case OP_HASH_BEGIN:
+            _hashes[instruction.first]->begin();
+            break;
+        case OP_HASH_UPDATE: {
+            const Register &value = _registers[instruction.first];
+            if(instruction.third)
+                _update_text(*_hashes[instruction.second], value);
+            else
+                _hashes[instruction.second]->update(value.data, value.size);
+            break;
+        }
+        case OP_HASH_FINAL: {
+            digest::Hash *hash = _hashes[instruction.first];
+            destination.storage.resize(hash->get_length());
+            hash->final(destination.storage.data());
+            destination.data = destination.storage.data();
+            destination.size = hash->get_length();
+            destination.bit_length = 8*destination.size;
+            destination.encoding = ENCODING_HEX_LOWER;
+            break;
+        }
+        case OP_EMIT:
+            _emitted[instruction.second] = &_registers[instruction.first];
+            break;
+        }
+
+        if constexpr (PROFILE){
+            uint64_t end = _read_ticks();
+            size_t bytes = 0;
+
+            if(instruction.opcode == OP_HASH_UPDATE){
+                const Register &value = _registers[instruction.first];
+                bytes = instruction.third && value.encoding != ENCODING_TEXT ? 2*value.size : value.size;
+            } else if(instruction.opcode != OP_HASH_BEGIN && instruction.opcode != OP_EMIT){
+                bytes = destination.size;
+            }
+
+            _profile[i].count++;
+            _profile[i].ticks += end - start;
+            _profile[i].bytes += bytes;
+        }
+    }
+}
+
+/* Public */
+
+const std::string &Vm::run(const decoder::Frame *target_frame) {
+    if(!target_frame)
+        throw std::invalid_argument("No frame given");
+    if(!target_frame->get_is_decoded())
+        throw std::invalid_argument("Given frame is not decoded");
+
+    std::fill(_emitted.begin(), _emitted.end(), nullptr);
+
+    try{
+        // The flag is tested once per run, not per instruction
+        if(_is_profiling)
+            _execute<true>(target_frame);
+        else
+            _execute<false>(target_frame);
+    }
+    catch(const std::exception& e){
+        std::string message = "Runtime error in code: ";
+        message += e.what();
+        throw std::runtime_error(message);
+    }
+
+    if(_outputs.empty())
+        throw std::runtime_error("No tree");
+
+    // The only encoding to text
+    for(size_t i = 0; i < _outputs.size(); ++i){
+        if(!_emitted[i])
+            throw std::runtime_error("No tree");
+
+        _outputs[i].clear();
+        _append_text(_outputs[i], *_emitted[i]);
+    }
+
+    return _outputs[0];
+}
+
+void Vm::run_batch(const decoder::Frame *const *frames, size_t count, std::string *outputs) {
+    if(count == 0)
+        return;
+    if(!frames || !outputs)
+        throw std::invalid_argument("No frames or no outputs given");
+    for(size_t i = 0; i < count; ++i)
+        if(!frames[i] || !frames[i]->get_is_decoded())
+            throw std::invalid_argument("Given frame is not decoded");
+
+    _reserve_batch(count);
+
+    const std::vector<Instruction> &code = _program->get_code();
+    const std::vector<decoder::Field> &fields = _program->get_fields();
+    const std::vector<Constant> &constants = _program->get_constants();
+    size_t output_count = _program->get_output_count();
+    std::vector<bool> is_emitted(output_count, false);
+
+    // The SHA-256 slots are hashed by Sha256_multi when the batch fills its lanes, the other algorithms keep a hash per frame
+    bool is_batch_multi = _is_sha256_multi && count >= digest::Sha256_multi::get_lanes(digest::Sha256_multi::get_best_kernel());
+    std::vector<bool> is_multi;
+    for(const Hash_slot &slot : _program->get_hashes())
+        is_multi.push_back(is_batch_multi && slot.algorithm == digest::ALGORITHM_SHA256);
+
+    try{
+        for(const Instruction &instruction : code){
+            Register *destination = &_batch_registers[instruction.destination * _batch_capacity];
+            const Register *source = &_batch_registers[instruction.first * _batch_capacity];
+
+            switch(instruction.opcode){
+            case OP_LOAD_CONST: {
+                const Constant &constant = constants[instruction.first];
+                for(size_t i = 0; i < count; ++i){
+                    destination[i].data = (const uint8_t *) constant.bytes.data();
+                    destination[i].size = constant.bytes.size();
+                    destination[i].bit_length = 8*constant.bytes.size();
+                    destination[i].encoding = constant.encoding;
+                }
+                break;
+            }
+            case OP_LOAD_FIELD: {
+                const decoder::Field &field = fields[instruction.first];
+                for(size_t i = 0; i < count; ++i){
+                    decoder::Span span;
+                    if(!frames[i]->get_field(field, span)){
+                        span.data = nullptr;
+                        span.size = 0;
+                    }
+                    destination[i].data = span.data;
+                    destination[i].size = span.size;
+                    destination[i].bit_length = 8*span.size;
+                    destination[i].encoding = ENCODING_HEX_UPPER;
+                }
+                break;
+            }
+            case OP_SLICE_BIT:
+                for(size_t i = 0; i < count; ++i)
+                    _slice_bit(destination[i], source[i], instruction.second, instruction.third);
+                break;
+            case OP_SLICE_BYTE:
+                for(size_t i = 0; i < count; ++i)
+                    _slice_byte(destination[i], source[i], instruction.second, instruction.third);
+                break;
+            case OP_HASH_BEGIN: {
+                if(is_multi[instruction.first]){
+                    std::string *messages = &_batch_messages[instruction.first * _batch_capacity];
+                    for(size_t i = 0; i < count; ++i)
+                        messages[i].clear();
+                    break;
+                }
+
+                digest::Hash **hashes = &_batch_hashes[instruction.first * _batch_capacity];
+                for(size_t i = 0; i < count; ++i)
+                    hashes[i]->begin();
+                break;
+            }
+            case OP_HASH_UPDATE: {
+                // The messages of Sha256_multi are whole, their bytes are gathered until the final
+                if(is_multi[instruction.second]){
+                    std::string *messages = &_batch_messages[instruction.second * _batch_capacity];
+                    if(instruction.third){
+                        for(size_t i = 0; i < count; ++i)
+                            _append_text(messages[i], source[i]);
+                    } else {
+                        for(size_t i = 0; i < count; ++i)
+                            messages[i].append((const char *) source[i].data, source[i].size);
+                    }
+                    break;
+                }
+
+                digest::Hash **hashes = &_batch_hashes[instruction.second * _batch_capacity];
+                if(instruction.third){
+                    for(size_t i = 0; i < count; ++i)
+                        _update_text(*hashes[i], source[i]);
+                } else {
+                    for(size_t i = 0; i < count; ++i)
+                        hashes[i]->update(source[i].data, source[i].size);
+                }
+                break;
+            }
+            case OP_HASH_FINAL: {
+                if(is_multi[instruction.first]){
+                    const std::string *messages = &_batch_messages[instruction.first * _batch_capacity];
+                    for(size_t i = 0; i < count; ++i){
+                        _batch_message_data[i] = (const uint8_t *) messages[i].data();
+                        _batch_message_sizes[i] = messages[i].size();
+                    }
+                    digest::Sha256_multi::digest(_batch_message_data.data(), _batch_message_sizes.data(), count, _batch_digests.data());
+
+                    for(size_t i = 0; i < count; ++i){
+                        destination[i].storage.assign(&_batch_digests[i * SHA256_LENGTH], &_batch_digests[(i+1) * SHA256_LENGTH]);
+                        destination[i].data = destination[i].storage.data();
+                        destination[i].size = SHA256_LENGTH;
+                        destination[i].bit_length = 8*SHA256_LENGTH;
+                        destination[i].encoding = ENCODING_HEX_LOWER;
+                    }
+                    break;
+                }
+
+                digest::Hash **hashes = &_batch_hashes[instruction.first * _batch_capacity];
+                size_t length = hashes[0]->get_length();
+                for(size_t i = 0; i < count; ++i){
+                    destination[i].storage.resize(length);
+                    hashes[i]->final(destination[i].storage.data());
+                    destination[i].data = destination[i].storage.data();
+                    destination[i].size = length;
+                    destination[i].bit_length = 8*length;
+                    destination[i].encoding = ENCODING_HEX_LOWER;
+                }
+                break;
+            }
+            case OP_EMIT:
+                // A register is never written again, so its text can be written at once
+                for(size_t i = 0; i < count; ++i){
+                    std::string &output = outputs[i * output_count + instruction.second];
+                    output.clear();
+                    _append_text(output, source[i]);
+                }
+                is_emitted[instruction.second] = true;
+                break;
+            }
+        }
+    }
+    catch(const std::exception& e){
+        std::string message = "Runtime error in code: ";
+        message += e.what();
+        throw std::runtime_error(message);
+    }
+
+    if(std::find(is_emitted.begin(), is_emitted.end(), false) != is_emitted.end() || output_count == 0)
+        throw std::runtime_error("No tree");
+}
+
+const std::vector<std::string> &Vm::get_outputs() const {
+    return _outputs;
+}
+
+void Vm::set_sha256_multi(bool is_sha256_multi) {
+    _is_sha256_multi = is_sha256_multi;
+}
+
+void Vm::set_profiling(bool is_profiling) {
+    _is_profiling = is_profiling;
+}
+
+const std::vector<Instruction_profile> &Vm::get_profile() const {
+    return _profile;
+}
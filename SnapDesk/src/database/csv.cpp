@@ -4,7 +4,7 @@ namespace database{
 
     /* Constructor */
 
-    Csv::Csv(std::string file_name){
+    Csv::Csv(std::string file_name) : _file_name(file_name) {
         _c_data = new os_communicator::Communicator(file_name+DATA_EXTENTION);
 
         if(!_c_data->exist())
@@ -20,18 +20,59 @@ namespace database{
 
         // Get key_column_number
         _key_column_number = _string_to_size_t(_c_metadata->get_line(KEY_LINE_NUMBER));
+
+        // Get output columns, a file created before them has not the line
+        _output_column_names = _line_to_values(_c_metadata->get_line(OUTPUT_COLUMNS_LINE_NUMBER));
+
+        _load();
+
+        // The writes since the last compaction
+        os_communicator::Communicator compacting_log(file_name+COMPACTING_LOG_EXTENTION);
+        _c_log = new os_communicator::Communicator(file_name+LOG_EXTENTION);
+
+        bool is_interrupted = compacting_log.exist();
+        bool is_damaged = false;
+        if(is_interrupted)
+            _replay(compacting_log, is_damaged);
+        if(_c_log->exist())
+            _log_records = _replay(*_c_log, is_damaged);
+
+        // A compaction that did not end is finished now, with the records of both logs. A log cut by a crash
+        // is compacted too, the next records would be glued to its last bytes.
+        if(is_interrupted || is_damaged){
+            _c_data->replace_content(_get_content());
+            compacting_log.remove();
+            _c_log->remove();
+            _log_records = 0;
+        }
     };
 
     Csv::~Csv(){
+        if(_compaction.joinable())
+            _compaction.join();
+
+        if(_c_log)
+            delete _c_log;
         if(_c_data)
             delete _c_data;
         if(_c_metadata)
             delete _c_metadata;
     };
 
-    Csv *Csv::create(std::string file_name, std::vector<std::string> column_names, size_t key_column_number){
+    Csv *Csv::create(std::string file_name, std::vector<std::string> column_names, size_t key_column_number, std::vector<std::string> output_column_names){
         os_communicator::Communicator *tmp;
 
+        if(key_column_number >= column_names.size())
+            throw invalid_argument("The key column " + std::to_string(key_column_number) + " does not exist");
+
+        for(std::string output_column_name : output_column_names)
+            if(std::count(column_names.begin(), column_names.end(), output_column_name) 
+                || std::count(output_column_names.begin(), output_column_names.end(), output_column_name) > 1)
+                throw invalid_argument("The column " + output_column_name + " does already exist");
+
+        // The output columns are next to the key
+        column_names.insert(column_names.begin() + key_column_number + 1, output_column_names.begin(), output_column_names.end());
+
         // Init of data
                 
         tmp = new os_communicator::Communicator(file_name+DATA_EXTENTION);
@@ -41,6 +82,10 @@ namespace database{
 
         delete tmp;
 
+        // A log left by a deleted csv file is not the one of the new file
+        os_communicator::Communicator(file_name+LOG_EXTENTION).remove();
+        os_communicator::Communicator(file_name+COMPACTING_LOG_EXTENTION).remove();
+
         // init of metadata
 
         tmp = new os_communicator::Communicator(file_name+METADATA_EXTENTION);
@@ -48,6 +93,7 @@ namespace database{
         tmp->new_file();
         tmp->add_line(std::to_string(key_column_number));
         tmp->add_line(std::to_string(column_names.size()));
+        tmp->add_line(Csv::_values_to_line(output_column_names));
 
         delete tmp;
 
@@ -56,6 +102,32 @@ namespace database{
 
     /* private */
 
+    void Csv::_load(){
+        std::string content = _c_data->get_content();
+        size_t start = 0;
+
+        for(size_t i = 0; start < content.size(); ++i){
+            size_t end = content.find('\n', start);
+            if(end == std::string::npos)
+                end = content.size();
+
+            std::string line = content.substr(start, end - start);
+            start = end + 1;
+
+            if(i == 0){
+                _header = line;
+                continue;
+            }
+
+            // As get_all_keys_with_value() did, the rows stop at the first empty line
+            if(line == "")
+                break;
+
+            _key_positions.emplace(_get_cell_from_row(line, _key_column_number), _rows.size());
+            _rows.push_back(line);
+        }
+    }
+
     void Csv::_test_values_size(std::vector<std::string> values){
         if(values.size() != _number_of_columns)
             throw invalid_argument("The size of row (" 
@@ -64,14 +136,126 @@ namespace database{
                 + std::to_string(_number_of_columns) + ")");
     };
 
+    bool Csv::_is_valid_record(size_t row_number, const std::string &line) const {
+        return row_number <= _rows.size() && line.find('\n') == std::string::npos
+            && (size_t) std::count(line.begin(), line.end(), DELIMITER[0]) == _number_of_columns;
+    }
+
+    bool Csv::_apply_record(size_t row_number, const std::string &line){
+        if(!_is_valid_record(row_number, line))
+            return false;
+
+        std::string key_value = _get_cell_from_row(line, _key_column_number);
+
+        if(row_number == _rows.size()){
+            _key_positions.emplace(key_value, row_number);
+            _rows.push_back(line);
+            return true;
+        }
+
+        // The row may get another key
+        std::string old_key_value = _get_cell_from_row(_rows[row_number], _key_column_number);
+        if(old_key_value != key_value){
+            auto it = _key_positions.find(old_key_value);
+            if(it != _key_positions.end() && it->second == row_number)
+                _key_positions.erase(it);
+            _key_positions.emplace(key_value, row_number);
+        }
+        _rows[row_number] = line;
+
+        return true;
+    }
+
+    size_t Csv::_replay(os_communicator::Communicator &log, bool &is_damaged){
+        std::string content = log.get_content();
+        size_t records = 0;
+        size_t start = 0;
+
+        while(start < content.size()){
+            size_t end = content.find('\n', start);
+            if(end == std::string::npos){
+                is_damaged = true;
+                break;
+            }
+
+            std::string record = content.substr(start, end - start);
+            start = end + 1;
+
+            // <row number>;<line>
+            size_t delimiter = record.find(DELIMITER);
+            if(delimiter == 0 || delimiter == std::string::npos || record.find_first_not_of("0123456789") != delimiter){
+                is_damaged = true;
+                continue;
+            }
+
+            if(_apply_record(_string_to_size_t(record.substr(0, delimiter)), record.substr(delimiter + 1)))
+                records++;
+            else
+                is_damaged = true;
+        }
+
+        return records;
+    }
+
+    void Csv::_append_record(size_t row_number, const std::string &line){
+        // A record that could not be read back is not written
+        if(!_is_valid_record(row_number, line))
+            throw invalid_argument("A value of the row contains \"" DELIMITER "\" or an end of line");
+
+        _c_log->add_line(std::to_string(row_number) + DELIMITER + line);
+        _apply_record(row_number, line);
+        _log_records++;
+
+        _compact();
+    }
+
+    std::string Csv::_get_content() const {
+        std::string content = _header + "\n";
+
+        for(const std::string &row : _rows)
+            content += row + "\n";
+
+        return content;
+    }
+
+    void Csv::_compact(){
+        if(_log_records < LOG_COMPACTION_RECORDS || _is_compacting)
+            return;
+
+        if(_compaction.joinable())
+            _compaction.join();
+
+        // The log of a compaction that failed is kept for the next opening of the file
+        os_communicator::Communicator compacting_log(_file_name+COMPACTING_LOG_EXTENTION);
+        if(compacting_log.exist())
+            return;
+
+        // The next records go to a new log, the rewritten csv file has the ones of the renamed log
+        _c_log->rename_to(_file_name+COMPACTING_LOG_EXTENTION);
+        _log_records = 0;
+
+        _is_compacting = true;
+        _compaction = std::thread(_rewrite, _file_name, _get_content(), &_is_compacting);
+    }
+
+    void Csv::_rewrite(std::string file_name, std::string content, std::atomic<bool> *is_compacting){
+        try{
+            os_communicator::Communicator(file_name+DATA_EXTENTION).replace_content(content);
+            os_communicator::Communicator(file_name+COMPACTING_LOG_EXTENTION).remove();
+        } catch(const std::exception &e){
+            fprintf(stderr, "The compaction of %s failed, it will end at its next opening: %s\n", file_name.c_str(), e.what());
+        }
+
+        *is_compacting = false;
+    }
+
     size_t Csv::_get_key_position(std::string key_value){
-        std::vector<std::string> keys = get_all_keys();
-        auto it = std::find(keys.begin(), keys.end(), key_value);
+        auto it = _key_positions.find(key_value);
 
-        if(it == keys.end())
+        if(it == _key_positions.end())
             return -1;
         else
-            return std::distance(keys.begin(), it);
+            return it->second;
     }
 
     std::string Csv::_values_to_line(std::vector<std::string> values){
@@ -83,6 +267,19 @@ namespace database{
         return line;
     };
 
+    std::vector<std::string> Csv::_line_to_values(std::string line){
+        std::vector<std::string> values;
+        size_t start = 0;
+        size_t end;
+
+        while((end = line.find(DELIMITER, start)) != std::string::npos){
+            values.push_back(line.substr(start, end - start));
+            start = end + 1;
+        }
+
+        return values;
+    };
+
     size_t Csv::_get_column_position_from_header(std::string header, std::string column_name){
         std::string line = header;
 
@@ -130,7 +327,7 @@ namespace database{
         if(_get_key_position(key_value) != -1)
             throw invalid_argument("The key " + key_value + " does already exist");
 
-        _c_data->add_line(_values_to_line(values));
+        _append_record(_rows.size(), _values_to_line(values));
     }
 
     void Csv::replace_row(size_t row_number, std::vector<std::string> values){
@@ -141,8 +338,10 @@ namespace database{
 
         if(!(key_position == row_number || key_position == -1))
             throw invalid_argument("The key " + key_value + " does already exist");
+        if(row_number >= _rows.size())
+            throw invalid_argument("The row number " + std::to_string((int) row_number) + " does not exist");
 
-        _c_data->replace_line(row_number+HEADER_SIZE, _values_to_line(values));
+        _append_record(row_number, _values_to_line(values));
     }
 
     std::string Csv::get_cell(size_t row_number, size_t column_number){
@@ -157,9 +356,11 @@ namespace database{
                 + " smaller that the minimal value " 
                 + std::to_string(HEADER_SIZE));
         
-        std::string line = _c_data->get_line(row_number+HEADER_SIZE);
+        // A row that does not exist has empty cells, as an empty line
+        if(row_number >= _rows.size())
+            return "";
 
-        return _get_cell_from_row(line, column_number);
+        return _get_cell_from_row(_rows[row_number], column_number);
     }
 
     size_t Csv::get_row_number(std::string key_value){
@@ -167,9 +368,7 @@ namespace database{
     }
 
     size_t Csv::get_column_number(std::string column_name){
-        std::string header = _c_data->get_line(0);
-
-        return _get_column_position_from_header(header, column_name);
+        return _get_column_position_from_header(_header, column_name);
     }
 
     std::vector<std::string> Csv::get_all_keys(){
@@ -185,17 +384,21 @@ namespace database{
 
         std::vector<std::string> keys;
 
-        size_t i = HEADER_SIZE;
+        // A key is in one row at most
+        if(column_number == _key_column_number && value != ""){
+            if(_get_key_position(value) != -1)
+                keys.push_back(value);
+            return keys;
+        }
 
-        while(1){
-            std::string line = _c_data->get_line(i);
-            if(line == "")
-                break;
-            if(value == "" || _get_cell_from_row(line, column_number) == value)
-                keys.push_back(_get_cell_from_row(line, _key_column_number));
-            ++i;
-        };
+        for(const std::string &row : _rows)
+            if(value == "" || _get_cell_from_row(row, column_number) == value)
+                keys.push_back(_get_cell_from_row(row, _key_column_number));
 
         return keys;
     }
+
+    const std::vector<std::string> &Csv::get_output_column_names() const {
+        return _output_column_names;
+    }
 }
\ No newline at end of file
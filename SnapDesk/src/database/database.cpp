@@ -3,65 +3,19 @@
 namespace database{
 
     std::string hash(std::string str){
-        unsigned char hash[EVP_MAX_MD_SIZE];
-        unsigned int hash_len;
-
-        EVP_MD_CTX* mdctx = EVP_MD_CTX_new();
-        if (mdctx == nullptr) {
-            throw std::runtime_error("Failed to create EVP_MD_CTX");
-        }
-
-        if (EVP_DigestInit_ex(mdctx, EVP_sha256(), nullptr) != 1) {
-            EVP_MD_CTX_free(mdctx);
-            throw std::runtime_error("Failed to initialize digest");
-        }
-
-        if (EVP_DigestUpdate(mdctx, str.c_str(), str.size()) != 1) {
-            EVP_MD_CTX_free(mdctx);
-            throw std::runtime_error("Failed to update digest");
-        }
-
-        if (EVP_DigestFinal_ex(mdctx, hash, &hash_len) != 1) {
-            EVP_MD_CTX_free(mdctx);
-            throw std::runtime_error("Failed to finalize digest");
-        }
-
-        std::string output = "";
-        for(size_t i = 0; i < hash_len; ++i){
-            char buf[3];
-            snprintf(buf, sizeof(buf), "%02x", hash[i]);
-            output += buf;
-        }
-
-        return output;
+        return digest::Sha256::hex_digest(str);
     }
 
     /* Constructor */
 
-    Database::Database(std::string ssid, std::string code_file_name) : _ssid(ssid), _code_file_name(code_file_name) {
+    Database::Database(std::string ssid, std::string code_file_name, std::string code_hash, std::vector<std::string> output_names) : _ssid(ssid), _code_file_name(code_file_name), _code_hash(code_hash) {
         // Get the folder path
-        std::replace(code_file_name.begin(), code_file_name.end(), '.', '_');
-        std::replace(code_file_name.begin(), code_file_name.end(), '/', '-');
-        std::string folder_name = std::string(DATABASE_ROOT) + "/" + code_file_name; //TODO handle folders and replacing "-" by "/"
+        std::string folder_name = _get_folder_name(code_file_name);
         
         os_communicator::Communicator::create_folder(folder_name);
 
-        std::string hashed_code = "";
-
-        // Get the code content
-        os_communicator::Communicator *tmp = new os_communicator::Communicator(_code_file_name);
-        if(tmp->exist()){
-            std::string last_line = tmp->get_line(0);
-            for(size_t i=1; last_line != ""; ++i){
-                hashed_code += last_line;
-                last_line = tmp->get_line(i);
-            }
-        }
-        delete tmp;
-
-        hashed_code = hash(hashed_code);
-
-        folder_name += "/" + hashed_code;
+        // The hash is the one of the compiled code, even if the file changed since
+        folder_name += "/" + _code_hash;
         
         os_communicator::Communicator::create_folder(folder_name);
 
@@ -72,11 +26,11 @@ namespace database{
         std::vector<std::string> column_names = COLUMN_NAMES;
 
         // get csv  
-        tmp = new os_communicator::Communicator(destination_file_name+DATA_EXTENTION);
+        os_communicator::Communicator *tmp = new os_communicator::Communicator(destination_file_name+DATA_EXTENTION);
         if(tmp->exist())
             _csv = new Csv(destination_file_name);
         else
-            _csv = Csv::create(destination_file_name, column_names, KEY_COLUMN_NUMBER);
+            _csv = Csv::create(destination_file_name, column_names, KEY_COLUMN_NUMBER, output_names);
         delete tmp;
     };
 
@@ -85,7 +39,28 @@ namespace database{
             delete _csv;
     };
 
+    /* Private */
+
+    std::string Database::_get_folder_name(std::string code_file_name){
+        std::replace(code_file_name.begin(), code_file_name.end(), '.', '_');
+        std::replace(code_file_name.begin(), code_file_name.end(), '/', '-');
+        return std::string(DATABASE_ROOT) + "/" + code_file_name; //TODO handle folders and replacing "-" by "/"
+    }
+
     /* Public */
+
+    void Database::adopt_legacy_folder(std::string code_file_name){
+        std::string folder_name = _get_folder_name(code_file_name);
+        std::string legacy_folder_name = std::string(DATABASE_ROOT) + "/" + DATABASE_LEGACY_FOLDER;
+
+        if(folder_name == legacy_folder_name || os_communicator::Communicator::get_file_type(folder_name) != F_NONE
+            || os_communicator::Communicator::get_file_type(legacy_folder_name) != F_FOLDER)
+            return;
+
+        // The hash folders move with it, so the APs already known stay known
+        os_communicator::Communicator legacy_folder(legacy_folder_name);
+        legacy_folder.rename_to(folder_name);
+    }
     
     std::string Database::get_cell(std::string key_value, std::string column_name){
         return _csv->get_cell(_csv->get_row_number(key_value), _csv->get_column_number(column_name));
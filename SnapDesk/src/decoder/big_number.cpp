@@ -139,6 +139,14 @@ Big_number Big_number::copy() const{
     return copy;
 }
 
+const uint8_t *Big_number::data() const {
+    return number.data();
+}
+
+size_t Big_number::size() const {
+    return number.size();
+}
+
 Big_number& Big_number::operator=(const Big_number _number) {
     number.clear();
 
@@ -196,7 +204,7 @@ Big_number Big_number::from_hex_string(const std::string string){
     const char *c_string = string.c_str();
 
     for(size_t i = 0; i < string.size(); i += 2){
-        char temp[2];
+        char temp[3]; // 2 digits + \0
         sprintf(temp, "%c%c", string.c_str()[i], string.c_str()[i+1]);
         number.push_back((uint8_t) std::stoul(temp, nullptr, 16));
     }
@@ -0,0 +1,34 @@
+#include "decoder/data_body.hpp"
+
+using namespace decoder;
+
+void Data_body::decode(){
+    _payload = Big_number::from_buffer_inv(_raw_body_buffer, _raw_buffer_size, _raw_buffer_size);
+}
+
+Data_body::Data_body(uint8_t *raw_body_buffer, size_t raw_buffer_size) : Body(raw_body_buffer, raw_buffer_size) {}
+
+void Data_body::print() const{
+    printf("Data body :\n");
+    printf("└─Payload----------------------: %s\n", _payload.hex_string().c_str());
+
+    printf("\n");
+    printf("==============================\n");
+}
+
+Big_number Data_body::get_value(string field) const{
+    if(field == "payload")
+        return _payload;
+
+    return Big_number::null();
+}
+
+bool Data_body::get_field(const Field &field, Span &span) const{
+    if(field.kind != FIELD_BODY || field.id != BODY_PAYLOAD || _payload.is_null())
+        return false;
+
+    span.data = _payload.data();
+    span.size = _payload.size();
+
+    return true;
+}
@@ -1,5 +1,6 @@
 #include "decoder/frame.hpp"
 #include "decoder/management_body.hpp"
+#include "decoder/data_body.hpp"
 
 using namespace decoder;
 
@@ -8,20 +9,63 @@ using namespace decoder;
 Frame::Frame(os_communicator::Communicator *_communicator){
     if(!_communicator)
         throw invalid_argument("No communicator given");
-                
+
+    init(_communicator);
+}
+
+Frame::Frame(){
+    init(nullptr);
+}
+
+Frame::~Frame(){
+    delete[] raw_frame_buffer;
+
+    if(body)
+        delete body;
+}
+
+/* Private */
+
+void Frame::init(os_communicator::Communicator *_communicator){
     communicator = _communicator;
     raw_buffer_size = FRAME_MAX_LENGTH;
     raw_frame_size = 0;
     raw_frame_buffer = new uint8_t[BEACON_FRAME_MAX_LENGTH];
     is_decoded = false;
     has_raw_data = false;
+    is_validated = false;
+    valid_body_length = 0;
+    validation_reason = REASON_VALID;
 }
 
-Frame::~Frame(){
-    delete[] raw_frame_buffer;
+template<uint8_t OFFSET, size_t SIZE>
+Big_number Frame::get_header_field() const {
+    if constexpr (OFFSET == NO_FIELD)
+        return Big_number::null();
+    else
+        return Big_number::from_buffer(raw_frame_buffer+OFFSET, SIZE, SIZE);
+}
 
-    if(body)
-        delete body;
+template<size_t LAYOUT>
+void Frame::decode_header(){
+    constexpr Header_layout layout = HEADER_LAYOUTS[LAYOUT];
+
+    frame_control = get_header_field<0, 2>();
+    duration = get_header_field<2, 2>();
+    destination_address = get_header_field<layout.destination_address, 6>();
+    source_address = get_header_field<layout.source_address, 6>();
+    bssid = get_header_field<layout.bssid, 6>();
+    receiver_address = get_header_field<layout.receiver_address, 6>();
+    transmitter_address = get_header_field<layout.transmitter_address, 6>();
+    address_4 = get_header_field<layout.address_4, 6>();
+    sequence_control = get_header_field<layout.sequence_control, 2>();
+    qos_control = get_header_field<layout.qos_control, 2>();
+    ht_control = get_header_field<layout.ht_control, 4>();
+}
+
+template<size_t... I>
+constexpr std::array<void (Frame::*)(), sizeof...(I)> Frame::get_header_decoders(std::index_sequence<I...>){
+    return {{&Frame::decode_header<I>...}};
 }
 
 /* Public */
@@ -31,9 +75,13 @@ bool Frame::get_is_decoded() const {
 }
 
 void Frame::update_raw_data(){
+    if(!communicator)
+        throw runtime_error("No communicator to get the frame from");
+
     raw_frame_size = communicator->in_buffer(raw_frame_buffer, raw_buffer_size);
 
     is_decoded = false;
+    is_validated = false;
 
     if(raw_buffer_size < raw_frame_size)
         throw runtime_error("Size of the frame greater than the buffer");
@@ -41,6 +89,26 @@ void Frame::update_raw_data(){
     has_raw_data = true;
 }
 
+void Frame::set_raw_data(const uint8_t *buffer, size_t size){
+    if(!buffer)
+        throw invalid_argument("No buffer given");
+    if(raw_buffer_size < size)
+        throw runtime_error("Size of the frame greater than the buffer");
+
+    std::copy(buffer, buffer+size, raw_frame_buffer);
+    raw_frame_size = size;
+
+    is_decoded = false;
+    is_validated = false;
+    has_raw_data = true;
+}
+
+const uint8_t *Frame::get_raw_data(size_t &size) const {
+    size = has_raw_data ? raw_frame_size : 0;
+
+    return has_raw_data ? raw_frame_buffer : nullptr;
+}
+
 void Frame::print_raw_data(){
     if(!has_raw_data){
         printf("no data\n");
@@ -55,50 +123,67 @@ void Frame::print_raw_data(){
     printf("\n");
 }
 
+Verdict Frame::validate(Validator &validator){
+    if(!has_raw_data)
+        throw runtime_error("No raw data given");
+
+    Validation validation;
+    Verdict verdict = validator.validate(raw_frame_buffer, raw_frame_size, validation);
+
+    is_validated = verdict != VERDICT_DROP;
+    valid_body_length = validation.body_length;
+    validation_reason = validation.reason;
+
+    return verdict;
+}
+
+Validation_reason Frame::get_validation_reason() const {
+    return validation_reason;
+}
+
 void Frame::decode(){
     if(!has_raw_data)
         throw runtime_error("No raw data given"); 
     if(is_decoded)
         return;
 
-    size_t cursor = 0;
-    size_t remain_length = raw_frame_size;
+    // 2 bytes of frame control and 4 bytes of FCS at least
+    if(raw_frame_size < 6)
+        throw runtime_error("Frame too short to be decoded");
+
+    uint16_t raw_frame_control = raw_frame_buffer[0] | (raw_frame_buffer[1] << 8);
+    size_t layout_index = get_header_layout_index(raw_frame_control);
+    const Header_layout &layout = HEADER_LAYOUTS[layout_index];
+
+    size_t type = (raw_frame_control >> 2) & 0x3;
+    size_t sub_type = (raw_frame_control >> 4) & 0xF;
+
+    if(layout.length == 0)
+        throw invalid_argument("No header layout for type " + to_string(type) + " and sub_type " + to_string(sub_type));
+    if(raw_frame_size < layout.length + 4)
+        throw runtime_error("Frame shorter than its header");
 
     // Get MAC header
-    frame_control = Big_number::from_buffer(raw_frame_buffer+cursor, remain_length, 2);
-    cursor += 2;
-    remain_length -= 2;
-    duration = Big_number::from_buffer(raw_frame_buffer+cursor, remain_length, 2);
-    cursor += 2;
-    remain_length -= 2;
-    destination_address = Big_number::from_buffer(raw_frame_buffer+cursor, remain_length, 6);
-    cursor += 6;
-    remain_length -= 6;
-    source_address = Big_number::from_buffer(raw_frame_buffer+cursor, remain_length, 6);
-    cursor += 6;
-    remain_length -= 6;
-    bssid = Big_number::from_buffer(raw_frame_buffer+cursor, remain_length, 6);
-    cursor += 6;
-    remain_length -= 6;
-    sequence_control = Big_number::from_buffer(raw_frame_buffer+cursor, remain_length, 2);
-    cursor += 2;
-    remain_length -= 2;
+    static constexpr std::array<void (Frame::*)(), HEADER_LAYOUT_COUNT> header_decoders =
+        get_header_decoders(std::make_index_sequence<HEADER_LAYOUT_COUNT>());
+
+    (this->*header_decoders[layout_index])();
+
     frame_check_sum = Big_number::from_buffer(raw_frame_buffer+raw_frame_size-4, 4, 4);
 
     // Get body
     if(body)
         delete body;
+    body = nullptr;
 
-    Big_number tmp = frame_control.copy();
-    tmp.cut_bit(2, 2);
-    size_t type = tmp.to_size_t();
-    
-    tmp = frame_control.copy();
-    tmp.cut_bit(4, 4);
-    size_t sub_type = tmp.to_size_t();
-    
     // -4 because last 4 bytes are FCS
-    body = Body::get_body(raw_frame_buffer+cursor, remain_length-4, type, sub_type);
+    size_t body_length = raw_frame_size - layout.length - 4;
+
+    if(is_validated)
+        body_length = std::min(body_length, valid_body_length);
+
+    if(body_length > 0)
+        body = Body::get_body(raw_frame_buffer+layout.length, body_length, type, sub_type);
 
     is_decoded = true;
 }
@@ -106,15 +191,32 @@ void Frame::decode(){
 void Frame::print() const {
     if(!is_decoded)
         return;
+
+    const std::pair<const char *, const Big_number *> fields[] = {
+        {"Frame control----------------", &frame_control},
+        {"Duration---------------------", &duration},
+        {"Destination address----------", &destination_address},
+        {"Source address---------------", &source_address},
+        {"BSSID------------------------", &bssid},
+        {"Receiver address-------------", &receiver_address},
+        {"Transmitter address----------", &transmitter_address},
+        {"Address 4--------------------", &address_4},
+        {"Sequence control-------------", &sequence_control},
+        {"QoS control------------------", &qos_control},
+        {"HT control-------------------", &ht_control},
+        {"Frame check sum (FCS)--------", &frame_check_sum},
+    };
                 
     printf("Frame Header :\n");
-    printf("├─Frame control----------------: %s\n", frame_control.hex_string().c_str());
-    printf("├─Duration---------------------: %s\n", duration.hex_string().c_str());
-    printf("├─Destination address----------: %s\n", destination_address.hex_string().c_str());
-    printf("├─Source address---------------: %s\n", source_address.hex_string().c_str());
-    printf("├─BSSID------------------------: %s\n", bssid.hex_string().c_str());
-    printf("├─Sequence control-------------: %s\n", sequence_control.hex_string().c_str());
-    printf("└─Frame check sum (FCS)--------: %s\n", frame_check_sum.hex_string().c_str());
+
+    for(const auto &field : fields){
+        if(field.second->is_null())
+            continue;
+
+        const char *branch = field.second == &frame_check_sum ? "└─" : "├─";
+
+        printf("%s%s: %s\n", branch, field.first, field.second->hex_string().c_str());
+    }
 
     printf("\n");
 
@@ -128,8 +230,6 @@ Big_number Frame::get_value(string field) const {
     if(!is_decoded)
         throw runtime_error("Frame must be encoded to get header value");
 
-    size_t value = 0;
-
     if (field == "frame_control")
         return frame_control;
     else if (field == "duration")
@@ -140,8 +240,18 @@ Big_number Frame::get_value(string field) const {
         return source_address;
     else if (field == "bssid")
         return bssid;
+    else if (field == "receiver_address")
+        return receiver_address;
+    else if (field == "transmitter_address")
+        return transmitter_address;
+    else if (field == "address_4")
+        return address_4;
     else if (field == "sequence_control")
         return sequence_control;
+    else if (field == "qos_control")
+        return qos_control;
+    else if (field == "ht_control")
+        return ht_control;
     else if (field == "frame_check_sum")
         return frame_check_sum;
     else if(body)
@@ -150,6 +260,190 @@ Big_number Frame::get_value(string field) const {
     return Big_number::null();
 };
 
+bool Frame::get_field(const Field &field, Span &span) const {
+    if(!is_decoded)
+        throw runtime_error("Frame must be encoded to get header value");
+
+    const Big_number *value = nullptr;
+
+    switch(field.kind){
+    case FIELD_HEADER:
+        switch(field.id){
+        case HEADER_FRAME_CONTROL: value = &frame_control; break;
+        case HEADER_DURATION: value = &duration; break;
+        case HEADER_DESTINATION_ADDRESS: value = &destination_address; break;
+        case HEADER_SOURCE_ADDRESS: value = &source_address; break;
+        case HEADER_BSSID: value = &bssid; break;
+        case HEADER_RECEIVER_ADDRESS: value = &receiver_address; break;
+        case HEADER_TRANSMITTER_ADDRESS: value = &transmitter_address; break;
+        case HEADER_ADDRESS_4: value = &address_4; break;
+        case HEADER_SEQUENCE_CONTROL: value = &sequence_control; break;
+        case HEADER_QOS_CONTROL: value = &qos_control; break;
+        case HEADER_HT_CONTROL: value = &ht_control; break;
+        case HEADER_FRAME_CHECK_SUM: value = &frame_check_sum; break;
+        default: return false;
+        }
+        break;
+    case FIELD_BODY:
+    case FIELD_SUB_FIELD:
+    case FIELD_IE:
+        return body && body->get_field(field, span);
+    default:
+        return false;
+    }
+
+    if(value->is_null())
+        return false;
+
+    span.data = value->data();
+    span.size = value->size();
+
+    return true;
+}
+
+bool Frame::peek_field(const Field &field, Span &span) const {
+    if(!has_raw_data || raw_frame_size < 6)
+        return false;
+
+    uint16_t raw_frame_control = raw_frame_buffer[0] | (raw_frame_buffer[1] << 8);
+    const Header_layout &layout = HEADER_LAYOUTS[get_header_layout_index(raw_frame_control)];
+
+    if(layout.length == 0 || raw_frame_size < layout.length + 4)
+        return false;
+
+    if(field.kind == FIELD_HEADER){
+        uint8_t offset = NO_FIELD;
+
+        switch(field.id){
+        case HEADER_FRAME_CONTROL: offset = 0; break;
+        case HEADER_DURATION: offset = 2; break;
+        case HEADER_DESTINATION_ADDRESS: offset = layout.destination_address; break;
+        case HEADER_SOURCE_ADDRESS: offset = layout.source_address; break;
+        case HEADER_BSSID: offset = layout.bssid; break;
+        case HEADER_RECEIVER_ADDRESS: offset = layout.receiver_address; break;
+        case HEADER_TRANSMITTER_ADDRESS: offset = layout.transmitter_address; break;
+        case HEADER_ADDRESS_4: offset = layout.address_4; break;
+        case HEADER_SEQUENCE_CONTROL: offset = layout.sequence_control; break;
+        case HEADER_QOS_CONTROL: offset = layout.qos_control; break;
+        case HEADER_HT_CONTROL: offset = layout.ht_control; break;
+        case HEADER_FRAME_CHECK_SUM:
+            span.data = raw_frame_buffer + raw_frame_size - 4;
+            span.size = 4;
+            return true;
+        default: return false;
+        }
+
+        if(offset == NO_FIELD)
+            return false;
+
+        span.data = raw_frame_buffer + offset;
+        span.size = get_field_width(field);
+        return true;
+    }
+
+    // Only a beacon has fixed fields and IEs, as in Body::get_body()
+    size_t type = (raw_frame_control >> 2) & 0x3;
+    size_t sub_type = (raw_frame_control >> 4) & 0xF;
+    if(type != TYPE_MANAGEMENT || sub_type != 8)
+        return false;
+
+    const uint8_t *raw_body = raw_frame_buffer + layout.length;
+    size_t body_length = raw_frame_size - layout.length - 4;
+    if(is_validated)
+        body_length = std::min(body_length, valid_body_length);
+
+    if(body_length < BEACON_FRAME_BODY_MIN_LENGTH)
+        return false;
+
+    if(field.kind == FIELD_BODY){
+        static const size_t BODY_OFFSETS[BODY_PAYLOAD] = {0, 8, 10};
+
+        if(field.id >= BODY_PAYLOAD)
+            return false;
+
+        span.data = raw_body + BODY_OFFSETS[field.id];
+        span.size = get_field_width(field);
+        return true;
+    }
+
+    if(field.kind != FIELD_IE)
+        return false;
+
+    // The first IE with the id, as Ie_node::find()
+    for(size_t cursor = BEACON_FRAME_BODY_MIN_LENGTH; cursor + 2 <= body_length;){
+        size_t length = raw_body[cursor+1];
+
+        if(cursor + 2 + length > body_length)
+            break;
+
+        if(raw_body[cursor] == field.id){
+            span.data = raw_body + cursor + 2;
+            span.size = length;
+            return true;
+        }
+
+        cursor += 2 + length;
+    }
+
+    return false;
+}
+
+Field Frame::resolve_field(const string &field) {
+    static const char *HEADER_NAMES[HEADER_FIELD_COUNT] = {
+        "frame_control", "duration", "destination_address", "source_address", "bssid", "receiver_address",
+        "transmitter_address", "address_4", "sequence_control", "qos_control", "ht_control", "frame_check_sum"};
+    static const char *BODY_NAMES[BODY_FIELD_COUNT] = {
+        "timestamp", "beacon_interval", "capabilities_information", "payload", "ie_order", "ie_set"};
+
+    for(size_t i = 0; i < HEADER_FIELD_COUNT; ++i)
+        if(field == HEADER_NAMES[i])
+            return {FIELD_HEADER, i};
+
+    for(size_t i = 0; i < BODY_FIELD_COUNT; ++i)
+        if(field == BODY_NAMES[i])
+            return {FIELD_BODY, i};
+
+    if(field.find('.') != string::npos){
+        size_t id = Sub_fields::get_id(field);
+
+        if(id == SUB_FIELD_COUNT)
+            return {FIELD_NONE, 0};
+
+        return {FIELD_SUB_FIELD, id};
+    }
+
+    if(field.empty())
+        throw invalid_argument("empty field name");
+
+    for(char c : field)
+        if(!isxdigit(c))
+            return {FIELD_NONE, 0};
+
+    // Same conversion as Ie_node::get_value(), ">221" is the element 0x21
+    return {FIELD_IE, (uint8_t) stoi(field, nullptr, 16)};
+}
+
+size_t Frame::get_field_width(const Field &field) {
+    // In the order of Header_field and Body_field
+    static const size_t HEADER_WIDTHS[HEADER_FIELD_COUNT] = {2, 2, 6, 6, 6, 6, 6, 6, 2, 2, 4, 4};
+    static const size_t BODY_WIDTHS[BODY_FIELD_COUNT] = {8, 2, 2, SIZE_MAX, SIZE_MAX, IE_SET_LENGTH};
+
+    if(field.kind == FIELD_HEADER && field.id < HEADER_FIELD_COUNT)
+        return HEADER_WIDTHS[field.id];
+    if(field.kind == FIELD_BODY && field.id < BODY_FIELD_COUNT)
+        return BODY_WIDTHS[field.id];
+
+    return SIZE_MAX;
+}
+
+bool Frame::is_peekable(const Field &field) {
+    return field.kind == FIELD_HEADER || field.kind == FIELD_IE || (field.kind == FIELD_BODY && field.id < BODY_PAYLOAD);
+}
+
+bool Frame::is_peek_reversed(const Field &field) {
+    return field.kind == FIELD_HEADER || field.kind == FIELD_BODY;
+}
+
 Body::Body(uint8_t *raw_body_buffer, size_t raw_buffer_size) : _raw_body_buffer(raw_body_buffer), _raw_buffer_size(raw_buffer_size) {
     if(!raw_body_buffer)
         throw invalid_argument("No buffer given");
@@ -173,6 +467,10 @@ Body *Body::get_body(uint8_t *raw_body_buffer, size_t raw_buffer_size, size_t ty
             break;
         }
         break;
+
+    case 2: // Data
+        new_body = new Data_body(raw_body_buffer, raw_buffer_size);
+        break;
     
     default:
         break;
@@ -0,0 +1,106 @@
+#include "decoder/frame_batch.hpp"
+
+using namespace decoder;
+
+#define AVERAGE_IE_PER_FRAME 16 ///<Used to reserve the IE columns
+
+/* Constructor */
+
+Frame_batch::Frame_batch(size_t capacity){
+    _is_valid.reserve(capacity);
+    _frame_control.reserve(capacity);
+    _bssid.reserve(capacity);
+    _sequence_control.reserve(capacity);
+    _body.reserve(capacity);
+    _body_length.reserve(capacity);
+    _ie_begin.reserve(capacity+1);
+    _ie_id.reserve(capacity*AVERAGE_IE_PER_FRAME);
+    _ie_offset.reserve(capacity*AVERAGE_IE_PER_FRAME);
+    _ie_length.reserve(capacity*AVERAGE_IE_PER_FRAME);
+}
+
+/* Private */
+
+void Frame_batch::_index_ies(const uint8_t *body, size_t body_length){
+    size_t cursor = BEACON_FRAME_BODY_MIN_LENGTH;
+
+    while(cursor + 2 <= body_length){
+        uint8_t element_length = body[cursor+1];
+
+        if(cursor + 2 + element_length > body_length)
+            break;
+
+        _ie_id.push_back(body[cursor]);
+        _ie_offset.push_back(cursor+2);
+        _ie_length.push_back(element_length);
+
+        cursor += 2 + element_length;
+    }
+}
+
+/* Public */
+
+void Frame_batch::decode(const uint8_t *const *frames, const size_t *sizes, size_t count){
+    _size = count;
+
+    _is_valid.resize(count);
+    _frame_control.resize(count);
+    _bssid.resize(count);
+    _sequence_control.resize(count);
+    _body.resize(count);
+    _body_length.resize(count);
+    _ie_begin.resize(count+1);
+    _ie_id.clear();
+    _ie_offset.clear();
+    _ie_length.clear();
+
+    // Header columns
+    for(size_t i = 0; i < count; ++i){
+        const uint8_t *frame = frames[i];
+        size_t size = sizes[i];
+
+        uint16_t frame_control = size >= 2 ? frame[0] | (frame[1] << 8) : 0;
+        const Header_layout &layout = HEADER_LAYOUTS[get_header_layout_index(frame_control)];
+
+        bool is_valid = layout.length != 0 && size >= layout.length + 4;
+
+        uint64_t bssid = 0;
+        if(is_valid && layout.bssid != NO_FIELD)
+            for(size_t j = 0; j < 6; ++j)
+                bssid |= ((uint64_t) frame[layout.bssid+j]) << (8*j);
+
+        _is_valid[i] = is_valid;
+        _frame_control[i] = frame_control;
+        _bssid[i] = bssid;
+        _sequence_control[i] = is_valid ? frame[layout.sequence_control] | (frame[layout.sequence_control+1] << 8) : 0;
+        _body[i] = is_valid ? frame + layout.length : nullptr;
+        _body_length[i] = is_valid ? size - layout.length - 4 : 0;
+    }
+
+    // IE offset tables, for beacons only
+    for(size_t i = 0; i < count; ++i){
+        _ie_begin[i] = _ie_id.size();
+
+        size_t type = (_frame_control[i] >> 2) & 0x3;
+        size_t sub_type = (_frame_control[i] >> 4) & 0xF;
+
+        if(_is_valid[i] && type == TYPE_MANAGEMENT && sub_type == 8)
+            _index_ies(_body[i], _body_length[i]);
+    }
+    _ie_begin[count] = _ie_id.size();
+}
+
+size_t Frame_batch::size() const {
+    return _size;
+}
+
+size_t Frame_batch::find_ie(size_t frame, uint8_t element_id) const {
+    if(frame >= _size)
+        throw invalid_argument("Frame " + to_string(frame) + " is not in the batch");
+
+    for(size_t i = _ie_begin[frame]; i < _ie_begin[frame+1]; ++i)
+        if(_ie_id[i] == element_id)
+            return i;
+
+    return -1;
+}
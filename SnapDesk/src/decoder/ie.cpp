@@ -53,6 +53,14 @@ Big_number Ie_node::get_value(std::string field) const {
     return Big_number::null();
 };
 
+const Big_number *Ie_node::find(uint8_t _element_id) const {
+    for(const Ie_node *node = this; node; node = node->next_element)
+        if(node->element_id == _element_id)
+            return &node->element_value;
+
+    return nullptr;
+}
+
 void Ie_node::print(){
     /* Print element_id */
 
@@ -6,6 +6,10 @@ void Beacon_body::decode(){
     size_t cursor = 0;
     size_t remain_length = _raw_buffer_size;
 
+    _sub_fields.reset(_raw_body_buffer);
+    _ie_order.clear();
+    memset(_ie_set, 0, sizeof(_ie_set));
+
     // Get Timestamp
     _timestamp = Big_number::from_buffer(_raw_body_buffer+cursor, remain_length, 8);
     cursor += 8;
@@ -22,16 +26,12 @@ void Beacon_body::decode(){
     remain_length -= 2;
 
     // Get Parameters
-    while(cursor < _raw_buffer_size){
+    while(cursor + 2 <= _raw_buffer_size){
         uint8_t element_id = _raw_body_buffer[cursor];
         uint8_t element_length = _raw_body_buffer[cursor+1];
 
-        // Early stopping if end of body reached
-        if(element_length == 0)
-            break;
-
-        // Stop if buffer overflow
-        if(!(element_length+cursor < _raw_buffer_size))
+        // Stop if buffer overflow, a validated frame never reach it
+        if(cursor + 2 + element_length > _raw_buffer_size)
             break;
 
         add_ie(element_id, element_length, cursor+2);  
@@ -54,6 +54,18 @@ void Beacon_body::add_ie(uint8_t element_id, uint8_t element_length, size_t star
         _first_ie = new_ie;
     else
         _first_ie->add(new_ie);
+
+    _sub_fields.decode_ie(element_id, start_position, element_length);
+
+    // The ids that are shared by many IEs are followed by the bytes telling them apart, 0 when the IE is too short
+    _ie_order.push_back(element_id);
+    if(element_id == P_EXTENSION)
+        _ie_order.push_back(element_length >= 1 ? _raw_body_buffer[start_position] : 0);
+    else if(element_id == P_VENDOR_SPECIFIC)
+        for(size_t i = 0; i < IE_OUI_LENGTH; ++i)
+            _ie_order.push_back(i < element_length ? _raw_body_buffer[start_position+i] : 0);
+
+    _ie_set[IE_SET_LENGTH - 1 - element_id/8] |= 1 << (element_id % 8);
 }
 
 Beacon_body::Beacon_body(uint8_t *raw_body_buffer, size_t raw_buffer_size) : Body(raw_body_buffer, raw_buffer_size) {}
@@ -76,10 +88,55 @@ void Beacon_body::print() const{
     if(_first_ie)
         _first_ie->print();
 
+    printf("\nSub-fields :\n");
+
+    _sub_fields.print();
+
     printf("\n");
     printf("==============================\n");
 }
 
+bool Beacon_body::get_field(const Field &field, Span &span) const{
+    const Big_number *value = nullptr;
+
+    switch(field.kind){
+    case FIELD_BODY:
+        // The order and the set of the IEs are not numbers, they are read from their buffers
+        if(field.id == BODY_IE_ORDER || field.id == BODY_IE_SET){
+            if(field.id == BODY_IE_ORDER && _ie_order.empty())
+                return false;
+
+            span.data = field.id == BODY_IE_ORDER ? _ie_order.data() : _ie_set;
+            span.size = field.id == BODY_IE_ORDER ? _ie_order.size() : IE_SET_LENGTH;
+            return true;
+        }
+
+        if(field.id == BODY_TIMESTAMP)
+            value = &_timestamp;
+        else if(field.id == BODY_BEACON_INTERVAL)
+            value = &_beacon_interval;
+        else if(field.id == BODY_CAPABILITIES_INFORMATION)
+            value = &_capabilities_information;
+        break;
+    case FIELD_SUB_FIELD:
+        return _sub_fields.get_span((Sub_field_id) field.id, span);
+    case FIELD_IE:
+        if(_first_ie)
+            value = _first_ie->find((uint8_t) field.id);
+        break;
+    default:
+        break;
+    }
+
+    if(!value || value->is_null())
+        return false;
+
+    span.data = value->data();
+    span.size = value->size();
+
+    return true;
+}
+
 Big_number Beacon_body::get_value(string field) const{
     Big_number value;
 
@@ -89,6 +146,12 @@ Big_number Beacon_body::get_value(string field) const{
         value = _beacon_interval;
     else if(field == "capabilities_information")
         value = _capabilities_information;
+    else if(field == "ie_order")
+        value = _ie_order.empty() ? Big_number::null() : Big_number::from_buffer_inv(_ie_order.data(), _ie_order.size(), _ie_order.size());
+    else if(field == "ie_set")
+        value = Big_number::from_buffer_inv(_ie_set, IE_SET_LENGTH, IE_SET_LENGTH);
+    else if(field.find('.') != string::npos)
+        value = _sub_fields.get_value(field);
     else if(_first_ie)
         value = _first_ie->get_value(field);
     else
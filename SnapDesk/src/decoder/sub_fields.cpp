@@ -0,0 +1,445 @@
+#include "decoder/sub_fields.hpp"
+
+using namespace decoder;
+
+#define NO_PARENT SUB_FIELD_COUNT ///<The parent of the sub-fields that are directly read from the IE
+#define LABEL_WIDTH 29 ///<The width of the labels when printing
+
+#define WPS_OUI_TYPE {0x00, 0x50, 0xF2, 0x04} ///<The OUI and the type of a WPS vendor specific element
+
+/**
+ * @brief Describe a sub-field, bit fields are extracted from their parent number
+ *
+ */
+struct Sub_field_descriptor {
+    const char *name; ///<The name of the sub-field used by getters
+    Sub_field_id parent; ///<The number from which the bits are extracted, or NO_PARENT
+    uint8_t bit_from; ///<The first bit of the bit field in its parent
+    uint8_t bit_count; ///<The number of bits of the bit field
+};
+
+/**
+ * @brief The descriptors of all sub-fields, in the order of Sub_field_id
+ *
+ */
+static const Sub_field_descriptor DESCRIPTORS[SUB_FIELD_COUNT] = {
+    // HT capabilities
+    {"ht.capabilities", NO_PARENT, 0, 0},
+    {"ht.ldpc", HT_CAPABILITIES, 0, 1},
+    {"ht.channel_width", HT_CAPABILITIES, 1, 1},
+    {"ht.sm_power_save", HT_CAPABILITIES, 2, 2},
+    {"ht.greenfield", HT_CAPABILITIES, 4, 1},
+    {"ht.short_gi_20", HT_CAPABILITIES, 5, 1},
+    {"ht.short_gi_40", HT_CAPABILITIES, 6, 1},
+    {"ht.tx_stbc", HT_CAPABILITIES, 7, 1},
+    {"ht.rx_stbc", HT_CAPABILITIES, 8, 2},
+    {"ht.delayed_block_ack", HT_CAPABILITIES, 10, 1},
+    {"ht.max_amsdu", HT_CAPABILITIES, 11, 1},
+    {"ht.dsss_cck_40", HT_CAPABILITIES, 12, 1},
+    {"ht.forty_mhz_intolerant", HT_CAPABILITIES, 14, 1},
+    {"ht.lsig_txop_protection", HT_CAPABILITIES, 15, 1},
+    {"ht.ampdu_parameters", NO_PARENT, 0, 0},
+    {"ht.max_ampdu_exponent", HT_AMPDU_PARAMETERS, 0, 2},
+    {"ht.min_mpdu_spacing", HT_AMPDU_PARAMETERS, 2, 3},
+    {"ht.mcs_set", NO_PARENT, 0, 0},
+    {"ht.extended_capabilities", NO_PARENT, 0, 0},
+    {"ht.txbf_capabilities", NO_PARENT, 0, 0},
+    {"ht.asel_capabilities", NO_PARENT, 0, 0},
+    // VHT capabilities
+    {"vht.capabilities", NO_PARENT, 0, 0},
+    {"vht.max_mpdu_length", VHT_CAPABILITIES, 0, 2},
+    {"vht.channel_width", VHT_CAPABILITIES, 2, 2},
+    {"vht.rx_ldpc", VHT_CAPABILITIES, 4, 1},
+    {"vht.short_gi_80", VHT_CAPABILITIES, 5, 1},
+    {"vht.short_gi_160", VHT_CAPABILITIES, 6, 1},
+    {"vht.tx_stbc", VHT_CAPABILITIES, 7, 1},
+    {"vht.rx_stbc", VHT_CAPABILITIES, 8, 3},
+    {"vht.su_beamformer", VHT_CAPABILITIES, 11, 1},
+    {"vht.su_beamformee", VHT_CAPABILITIES, 12, 1},
+    {"vht.beamformee_sts", VHT_CAPABILITIES, 13, 3},
+    {"vht.sounding_dimensions", VHT_CAPABILITIES, 16, 3},
+    {"vht.mu_beamformer", VHT_CAPABILITIES, 19, 1},
+    {"vht.mu_beamformee", VHT_CAPABILITIES, 20, 1},
+    {"vht.max_ampdu_exponent", VHT_CAPABILITIES, 23, 3},
+    {"vht.rx_mcs_map", NO_PARENT, 0, 0},
+    {"vht.rx_highest_rate", NO_PARENT, 0, 0},
+    {"vht.tx_mcs_map", NO_PARENT, 0, 0},
+    {"vht.tx_highest_rate", NO_PARENT, 0, 0},
+    // HE capabilities
+    {"he.mac_capabilities", NO_PARENT, 0, 0},
+    {"he.phy_capabilities", NO_PARENT, 0, 0},
+    {"he.mcs_nss_set", NO_PARENT, 0, 0},
+    {"he.htc_he", NO_PARENT, 0, 0},
+    {"he.twt_requester", NO_PARENT, 0, 0},
+    {"he.twt_responder", NO_PARENT, 0, 0},
+    {"he.channel_width_set", NO_PARENT, 0, 0},
+    {"he.ldpc_payload", NO_PARENT, 0, 0},
+    {"he.ppe_thresholds_present", NO_PARENT, 0, 0},
+    {"he.su_beamformer", NO_PARENT, 0, 0},
+    {"he.su_beamformee", NO_PARENT, 0, 0},
+    {"he.mu_beamformer", NO_PARENT, 0, 0},
+    {"he.rx_mcs_80", NO_PARENT, 0, 0},
+    {"he.tx_mcs_80", NO_PARENT, 0, 0},
+    // RSN
+    {"rsn.version", NO_PARENT, 0, 0},
+    {"rsn.group_cipher", NO_PARENT, 0, 0},
+    {"rsn.pairwise_count", NO_PARENT, 0, 0},
+    {"rsn.pairwise_ciphers", NO_PARENT, 0, 0},
+    {"rsn.akm_count", NO_PARENT, 0, 0},
+    {"rsn.akm_suites", NO_PARENT, 0, 0},
+    {"rsn.capabilities", NO_PARENT, 0, 0},
+    {"rsn.preauthentication", RSN_CAPABILITIES, 0, 1},
+    {"rsn.ptksa_replay_counter", RSN_CAPABILITIES, 2, 2},
+    {"rsn.gtksa_replay_counter", RSN_CAPABILITIES, 4, 2},
+    {"rsn.mfp_required", RSN_CAPABILITIES, 6, 1},
+    {"rsn.mfp_capable", RSN_CAPABILITIES, 7, 1},
+    {"rsn.pmkid_count", NO_PARENT, 0, 0},
+    {"rsn.group_management_cipher", NO_PARENT, 0, 0},
+    // WPS
+    {"wps.version", NO_PARENT, 0, 0},
+    {"wps.state", NO_PARENT, 0, 0},
+    {"wps.ap_setup_locked", NO_PARENT, 0, 0},
+    {"wps.response_type", NO_PARENT, 0, 0},
+    {"wps.uuid", NO_PARENT, 0, 0},
+    {"wps.manufacturer", NO_PARENT, 0, 0},
+    {"wps.model_name", NO_PARENT, 0, 0},
+    {"wps.model_number", NO_PARENT, 0, 0},
+    {"wps.serial_number", NO_PARENT, 0, 0},
+    {"wps.device_name", NO_PARENT, 0, 0},
+    {"wps.primary_device_type", NO_PARENT, 0, 0},
+    {"wps.config_methods", NO_PARENT, 0, 0},
+    {"wps.rf_bands", NO_PARENT, 0, 0},
+    {"wps.vendor_extension", NO_PARENT, 0, 0},
+};
+
+/**
+ * @brief Link a WPS attribute type to its sub-field
+ *
+ */
+struct Wps_attribute {
+    uint16_t type; ///<The type of the attribute
+    Sub_field_id id; ///<The sub-field holding the attribute
+};
+
+static const Wps_attribute WPS_ATTRIBUTES[] = {
+    {0x104A, WPS_VERSION},
+    {0x1044, WPS_STATE},
+    {0x1057, WPS_AP_SETUP_LOCKED},
+    {0x103B, WPS_RESPONSE_TYPE},
+    {0x1047, WPS_UUID},
+    {0x1021, WPS_MANUFACTURER},
+    {0x1023, WPS_MODEL_NAME},
+    {0x1024, WPS_MODEL_NUMBER},
+    {0x1042, WPS_SERIAL_NUMBER},
+    {0x1011, WPS_DEVICE_NAME},
+    {0x1054, WPS_PRIMARY_DEVICE_TYPE},
+    {0x1008, WPS_CONFIG_METHODS},
+    {0x103C, WPS_RF_BANDS},
+    {0x1049, WPS_VENDOR_EXTENSION},
+};
+
+/* private */
+
+void Sub_fields::_set_raw(Sub_field_id id, size_t position, size_t length){
+    _position[id] = position;
+    _length[id] = length;
+    _is_number[id] = false;
+    _present[id] = true;
+}
+
+void Sub_fields::_set_number(Sub_field_id id, uint64_t value, size_t length){
+    if(_numbers_size + length > SUB_FIELDS_NUMBERS_SIZE)
+        throw std::runtime_error("no more space to decode sub-fields");
+
+    for(size_t i = 0; i < length; ++i)
+        _numbers[_numbers_size + i] = (value >> (8*(length-1-i))) & 0xFF;
+
+    _position[id] = _numbers_size;
+    _length[id] = length;
+    _is_number[id] = true;
+    _present[id] = true;
+
+    _numbers_size += length;
+}
+
+void Sub_fields::_set_le_number(Sub_field_id id, size_t position, size_t length){
+    uint64_t value = 0;
+
+    for(size_t i = 0; i < length; ++i)
+        value |= ((uint64_t) _raw_body_buffer[position+i]) << (8*i);
+
+    _set_number(id, value, length);
+}
+
+uint64_t Sub_fields::_get_number(Sub_field_id id) const {
+    uint64_t value = 0;
+
+    for(size_t i = 0; i < _length[id]; ++i)
+        value = (value << 8) | _numbers[_position[id]+i];
+
+    return value;
+}
+
+void Sub_fields::_set_bit_fields(Sub_field_id first, Sub_field_id last){
+    for(size_t i = first; i <= last; ++i){
+        const Sub_field_descriptor &descriptor = DESCRIPTORS[i];
+
+        if(descriptor.parent == NO_PARENT || !_present[descriptor.parent])
+            continue;
+
+        uint64_t value = _get_number(descriptor.parent) >> descriptor.bit_from;
+        value &= (((uint64_t) 1) << descriptor.bit_count) - 1;
+
+        _set_number((Sub_field_id) i, value, (descriptor.bit_count + 7) / 8);
+    }
+}
+
+void Sub_fields::_decode_ht(size_t position, size_t length){
+    if(length >= 2)
+        _set_le_number(HT_CAPABILITIES, position, 2);
+    if(length >= 3)
+        _set_le_number(HT_AMPDU_PARAMETERS, position+2, 1);
+    if(length >= 19)
+        _set_raw(HT_MCS_SET, position+3, 16);
+    if(length >= 21)
+        _set_le_number(HT_EXTENDED_CAPABILITIES, position+19, 2);
+    if(length >= 25)
+        _set_le_number(HT_TXBF_CAPABILITIES, position+21, 4);
+    if(length >= 26)
+        _set_le_number(HT_ASEL_CAPABILITIES, position+25, 1);
+
+    _set_bit_fields(HT_CAPABILITIES, HT_ASEL_CAPABILITIES);
+}
+
+void Sub_fields::_decode_vht(size_t position, size_t length){
+    if(length >= 4)
+        _set_le_number(VHT_CAPABILITIES, position, 4);
+
+    _set_bit_fields(VHT_CAPABILITIES, VHT_MAX_AMPDU_EXPONENT);
+
+    if(length >= 12){
+        _set_le_number(VHT_RX_MCS_MAP, position+4, 2);
+        _set_number(VHT_RX_HIGHEST_RATE, (_raw_body_buffer[position+6] | (_raw_body_buffer[position+7] << 8)) & 0x1FFF, 2);
+        _set_le_number(VHT_TX_MCS_MAP, position+8, 2);
+        _set_number(VHT_TX_HIGHEST_RATE, (_raw_body_buffer[position+10] | (_raw_body_buffer[position+11] << 8)) & 0x1FFF, 2);
+    }
+}
+
+void Sub_fields::_decode_he(size_t position, size_t length){
+    // MAC capabilities (6 bytes) then PHY capabilities (11 bytes) then the MCS and NSS set
+    if(length < 17)
+        return;
+
+    const uint8_t *mac = _raw_body_buffer + position;
+    const uint8_t *phy = _raw_body_buffer + position + 6;
+
+    _set_raw(HE_MAC_CAPABILITIES, position, 6);
+    _set_raw(HE_PHY_CAPABILITIES, position+6, 11);
+
+    _set_number(HE_HTC_HE, mac[0] & 0x01, 1);
+    _set_number(HE_TWT_REQUESTER, (mac[0] >> 1) & 0x01, 1);
+    _set_number(HE_TWT_RESPONDER, (mac[0] >> 2) & 0x01, 1);
+    _set_number(HE_CHANNEL_WIDTH_SET, (phy[0] >> 1) & 0x7F, 1);
+    _set_number(HE_LDPC_PAYLOAD, (phy[1] >> 5) & 0x01, 1);
+    _set_number(HE_PPE_THRESHOLDS_PRESENT, (phy[2] >> 7) & 0x01, 1);
+    _set_number(HE_SU_BEAMFORMER, (phy[3] >> 7) & 0x01, 1);
+    _set_number(HE_SU_BEAMFORMEE, phy[4] & 0x01, 1);
+    _set_number(HE_MU_BEAMFORMER, (phy[4] >> 1) & 0x01, 1);
+
+    // <= 80 MHz set is always present, 160 MHz (bit 3) and 80+80 MHz (bit 4) sets are optional
+    size_t mcs_length = 4;
+    if(phy[0] & 0x08)
+        mcs_length += 4;
+    if(phy[0] & 0x10)
+        mcs_length += 4;
+
+    if(length < 17 + mcs_length)
+        return;
+
+    _set_raw(HE_MCS_NSS_SET, position+17, mcs_length);
+    _set_le_number(HE_RX_MCS_80, position+17, 2);
+    _set_le_number(HE_TX_MCS_80, position+19, 2);
+}
+
+void Sub_fields::_decode_rsn(size_t position, size_t length){
+    size_t cursor = position;
+    size_t end = position + length;
+
+    if(cursor + 2 > end)
+        return;
+    _set_le_number(RSN_VERSION, cursor, 2);
+    cursor += 2;
+
+    if(cursor + 4 > end)
+        return;
+    _set_raw(RSN_GROUP_CIPHER, cursor, 4);
+    cursor += 4;
+
+    if(cursor + 2 > end)
+        return;
+    size_t pairwise_count = _raw_body_buffer[cursor] | (_raw_body_buffer[cursor+1] << 8);
+    _set_number(RSN_PAIRWISE_COUNT, pairwise_count, 2);
+    cursor += 2;
+
+    if(cursor + 4*pairwise_count > end)
+        return;
+    _set_raw(RSN_PAIRWISE_CIPHERS, cursor, 4*pairwise_count);
+    cursor += 4*pairwise_count;
+
+    if(cursor + 2 > end)
+        return;
+    size_t akm_count = _raw_body_buffer[cursor] | (_raw_body_buffer[cursor+1] << 8);
+    _set_number(RSN_AKM_COUNT, akm_count, 2);
+    cursor += 2;
+
+    if(cursor + 4*akm_count > end)
+        return;
+    _set_raw(RSN_AKM_SUITES, cursor, 4*akm_count);
+    cursor += 4*akm_count;
+
+    if(cursor + 2 > end)
+        return;
+    _set_le_number(RSN_CAPABILITIES, cursor, 2);
+    _set_bit_fields(RSN_PREAUTHENTICATION, RSN_MFP_CAPABLE);
+    cursor += 2;
+
+    if(cursor + 2 > end)
+        return;
+    size_t pmkid_count = _raw_body_buffer[cursor] | (_raw_body_buffer[cursor+1] << 8);
+    _set_number(RSN_PMKID_COUNT, pmkid_count, 2);
+    cursor += 2 + 16*pmkid_count;
+
+    if(cursor + 4 > end)
+        return;
+    _set_raw(RSN_GROUP_MANAGEMENT_CIPHER, cursor, 4);
+}
+
+void Sub_fields::_decode_wps(size_t position, size_t length){
+    size_t cursor = position;
+    size_t end = position + length;
+
+    // Attributes are type (2 bytes) length (2 bytes) value, big endian
+    while(cursor + 4 <= end){
+        uint16_t type = (_raw_body_buffer[cursor] << 8) | _raw_body_buffer[cursor+1];
+        size_t attribute_length = (_raw_body_buffer[cursor+2] << 8) | _raw_body_buffer[cursor+3];
+
+        if(cursor + 4 + attribute_length > end)
+            break;
+
+        for(const Wps_attribute &attribute : WPS_ATTRIBUTES){
+            if(attribute.type == type && !_present[attribute.id]){
+                _set_raw(attribute.id, cursor+4, attribute_length);
+                break;
+            }
+        }
+
+        cursor += 4 + attribute_length;
+    }
+}
+
+/* Constructor */
+
+Sub_fields::Sub_fields(){
+    reset(nullptr);
+}
+
+/* Public */
+
+void Sub_fields::reset(const uint8_t *raw_body_buffer){
+    _raw_body_buffer = raw_body_buffer;
+    _numbers_size = 0;
+
+    for(size_t i = 0; i < SUB_FIELD_COUNT; ++i)
+        _present[i] = false;
+}
+
+void Sub_fields::decode_ie(uint8_t element_id, size_t position, size_t length){
+    if(!_raw_body_buffer)
+        throw std::invalid_argument("No body buffer given to decode sub-fields");
+
+    const uint8_t *content = _raw_body_buffer + position;
+
+    switch(element_id){
+    case P_HT_CAPABILITIES:
+        if(!_present[HT_CAPABILITIES])
+            _decode_ht(position, length);
+        break;
+    case P_VHT_CAPABILITIES:
+        if(!_present[VHT_CAPABILITIES])
+            _decode_vht(position, length);
+        break;
+    case P_RSN:
+        if(!_present[RSN_VERSION])
+            _decode_rsn(position, length);
+        break;
+    case P_EXTENSION:
+        if(length >= 1 && content[0] == P_EXT_HE_CAPABILITIES && !_present[HE_MAC_CAPABILITIES])
+            _decode_he(position+1, length-1);
+        break;
+    case P_VENDOR_SPECIFIC: {
+        const uint8_t wps_oui_type[] = WPS_OUI_TYPE;
+        if(length >= 4 && std::equal(wps_oui_type, wps_oui_type+4, content))
+            _decode_wps(position+4, length-4);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+Big_number Sub_fields::get_value(Sub_field_id id) const {
+    if(id >= SUB_FIELD_COUNT || !_present[id])
+        return Big_number::null();
+
+    const uint8_t *value = (_is_number[id] ? _numbers : _raw_body_buffer) + _position[id];
+
+    return Big_number::from_buffer_inv(value, _length[id], _length[id]);
+}
+
+Big_number Sub_fields::get_value(std::string field) const {
+    return get_value((Sub_field_id) get_id(field));
+}
+
+bool Sub_fields::get_span(Sub_field_id id, Span &span) const {
+    if(id >= SUB_FIELD_COUNT || !_present[id])
+        return false;
+
+    span.data = (_is_number[id] ? _numbers : _raw_body_buffer) + _position[id];
+    span.size = _length[id];
+
+    return true;
+}
+
+void Sub_fields::print() const {
+    size_t last = SUB_FIELD_COUNT;
+
+    for(size_t i = 0; i < SUB_FIELD_COUNT; ++i)
+        if(_present[i])
+            last = i;
+
+    for(size_t i = 0; i < SUB_FIELD_COUNT; ++i){
+        if(!_present[i])
+            continue;
+
+        std::string label = DESCRIPTORS[i].name;
+        if(label.size() < LABEL_WIDTH)
+            label.append(LABEL_WIDTH - label.size(), '-');
+
+        printf("%s%s: %s\n", i == last ? "└─" : "├─", label.c_str(), get_value((Sub_field_id) i).hex_string().c_str());
+    }
+}
+
+size_t Sub_fields::get_id(std::string field){
+    for(size_t i = 0; i < SUB_FIELD_COUNT; ++i)
+        if(field == DESCRIPTORS[i].name)
+            return i;
+
+    return SUB_FIELD_COUNT;
+}
+
+const char *Sub_fields::get_name(Sub_field_id id){
+    if(id >= SUB_FIELD_COUNT)
+        throw std::invalid_argument("Unknown sub-field");
+
+    return DESCRIPTORS[id].name;
+}
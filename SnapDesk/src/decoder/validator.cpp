@@ -0,0 +1,129 @@
+#include "decoder/validator.hpp"
+
+using namespace decoder;
+
+#define LABEL_WIDTH 29 ///<The width of the labels when printing
+
+/* Private */
+
+Verdict Validator::_conclude(Validation &validation, Verdict verdict, Validation_reason reason){
+    validation.verdict = verdict;
+    validation.reason = reason;
+
+    if(verdict == VERDICT_DROP){
+        validation.header_length = 0;
+        validation.body_length = 0;
+    }
+
+    _counters[reason]++;
+
+    return verdict;
+}
+
+/* Public */
+
+Verdict Validator::validate(const uint8_t *frame, size_t size, Validation &validation){
+    // 2 bytes of frame control and 4 bytes of FCS at least
+    if(!frame || size < 6)
+        return _conclude(validation, VERDICT_DROP, REASON_TOO_SHORT);
+
+    uint16_t frame_control = frame[0] | (frame[1] << 8);
+    const Header_layout &layout = HEADER_LAYOUTS[get_header_layout_index(frame_control)];
+    size_t type = (frame_control >> 2) & 0x3;
+    size_t sub_type = (frame_control >> 4) & 0xF;
+
+    // Must match the bodies known by Body::get_body()
+    bool is_beacon = type == TYPE_MANAGEMENT && sub_type == 8;
+    bool is_data = type == TYPE_DATA;
+
+    if(layout.length == 0 || !(is_beacon || is_data))
+        return _conclude(validation, VERDICT_DROP, REASON_UNSUPPORTED);
+
+    if(size < layout.length + 4)
+        return _conclude(validation, VERDICT_DROP, REASON_HEADER_TRUNCATED);
+
+    validation.header_length = layout.length;
+    validation.body_length = size - layout.length - 4;
+
+    if(!is_beacon)
+        return _conclude(validation, VERDICT_ACCEPT, REASON_VALID);
+
+    if(validation.body_length < BEACON_FRAME_BODY_MIN_LENGTH)
+        return _conclude(validation, VERDICT_DROP, REASON_BODY_TOO_SHORT);
+
+    // The IE chain must end exactly at the end of the body
+    const uint8_t *body = frame + layout.length;
+    size_t cursor = BEACON_FRAME_BODY_MIN_LENGTH;
+
+    while(cursor < validation.body_length){
+        if(cursor + 2 > validation.body_length){
+            validation.body_length = cursor;
+            return _conclude(validation, VERDICT_TRUNCATE, REASON_IE_HEADER_TRUNCATED);
+        }
+
+        size_t next = cursor + 2 + body[cursor+1];
+
+        if(next > validation.body_length){
+            validation.body_length = cursor;
+            return _conclude(validation, VERDICT_TRUNCATE, REASON_IE_OVERFLOW);
+        }
+
+        cursor = next;
+    }
+
+    return _conclude(validation, VERDICT_ACCEPT, REASON_VALID);
+}
+
+size_t Validator::get_count(Validation_reason reason) const {
+    if(reason >= REASON_COUNT)
+        return 0;
+
+    return _counters[reason];
+}
+
+void Validator::print() const {
+    printf("Validation :\n");
+
+    for(size_t i = 0; i < REASON_COUNT; ++i){
+        Validation_reason reason = (Validation_reason) i;
+        const char *verdict = get_verdict(reason) == VERDICT_ACCEPT ? "accept" : get_verdict(reason) == VERDICT_TRUNCATE ? "truncate" : "drop";
+
+        std::string label = get_name(reason);
+        label.append(LABEL_WIDTH - label.size(), '-');
+
+        printf("%s%s: %zu (%s)\n", i == REASON_COUNT-1 ? "└─" : "├─", label.c_str(), _counters[i], verdict);
+    }
+}
+
+Verdict Validator::get_verdict(Validation_reason reason){
+    switch(reason){
+    case REASON_VALID:
+        return VERDICT_ACCEPT;
+    case REASON_IE_HEADER_TRUNCATED:
+    case REASON_IE_OVERFLOW:
+        return VERDICT_TRUNCATE;
+    default:
+        return VERDICT_DROP;
+    }
+}
+
+const char *Validator::get_name(Validation_reason reason){
+    switch(reason){
+    case REASON_VALID:
+        return "valid";
+    case REASON_TOO_SHORT:
+        return "too short";
+    case REASON_UNSUPPORTED:
+        return "unsupported type";
+    case REASON_HEADER_TRUNCATED:
+        return "header truncated";
+    case REASON_BODY_TOO_SHORT:
+        return "body too short";
+    case REASON_IE_HEADER_TRUNCATED:
+        return "IE header truncated";
+    case REASON_IE_OVERFLOW:
+        return "IE overflow";
+    default:
+        return "unknown";
+    }
+}
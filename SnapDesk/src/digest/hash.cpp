@@ -0,0 +1,64 @@
+#include "digest/hash.hpp"
+#include "digest/sha256.hpp"
+#include "digest/xxh64.hpp"
+#include "digest/siphash.hpp"
+
+using namespace digest;
+
+/* Public */
+
+Hash *Hash::create(Algorithm algorithm, const std::string &key){
+    switch(algorithm){
+    case ALGORITHM_SHA256:
+        return new Sha256();
+    case ALGORITHM_XXH64:
+        return new Xxh64();
+    case ALGORITHM_XXH128:
+        return new Xxh128();
+    case ALGORITHM_SIPHASH64:
+        return new Siphash(key, 8);
+    case ALGORITHM_SIPHASH128:
+        return new Siphash(key, 16);
+    }
+
+    throw std::invalid_argument("Unknown hash algorithm");
+}
+
+size_t Hash::get_length(Algorithm algorithm){
+    switch(algorithm){
+    case ALGORITHM_SHA256:
+        return SHA256_LENGTH;
+    case ALGORITHM_XXH64:
+    case ALGORITHM_SIPHASH64:
+        return 8;
+    case ALGORITHM_XXH128:
+    case ALGORITHM_SIPHASH128:
+        return 16;
+    }
+
+    throw std::invalid_argument("Unknown hash algorithm");
+}
+
+size_t Hash::get_key_length(Algorithm algorithm){
+    if(algorithm == ALGORITHM_SIPHASH64 || algorithm == ALGORITHM_SIPHASH128)
+        return SIPHASH_KEY_LENGTH;
+
+    return 0;
+}
+
+const char *Hash::get_name(Algorithm algorithm){
+    switch(algorithm){
+    case ALGORITHM_SHA256:
+        return "sha256";
+    case ALGORITHM_XXH64:
+        return "xxh64";
+    case ALGORITHM_XXH128:
+        return "xxh128";
+    case ALGORITHM_SIPHASH64:
+        return "siphash64";
+    case ALGORITHM_SIPHASH128:
+        return "siphash128";
+    }
+
+    return "unknown";
+}
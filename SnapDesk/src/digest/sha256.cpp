@@ -0,0 +1,88 @@
+#include "digest/sha256.hpp"
+
+using namespace digest;
+
+/* Constructor */
+
+Sha256::Sha256(){
+    _context = EVP_MD_CTX_new();
+    if(!_context)
+        throw std::runtime_error("Failed to create EVP_MD_CTX");
+}
+
+Sha256::~Sha256(){
+    EVP_MD_CTX_free(_context);
+}
+
+/* Private */
+
+const EVP_MD *Sha256::_get_algorithm(){
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    // Fetching is done by EVP_sha256() on each initialisation otherwise
+    static EVP_MD *algorithm = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+
+    if(!algorithm)
+        throw std::runtime_error("Failed to fetch SHA256");
+
+    return algorithm;
+#else
+    return EVP_sha256();
+#endif
+}
+
+/* Public */
+
+void Sha256::begin(){
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    if(EVP_DigestInit_ex2(_context, _get_algorithm(), nullptr) != 1)
+#else
+    if(EVP_DigestInit_ex(_context, _get_algorithm(), nullptr) != 1)
+#endif
+        throw std::runtime_error("Failed to initialize digest");
+}
+
+void Sha256::update(const void *data, size_t size){
+    if(EVP_DigestUpdate(_context, data, size) != 1)
+        throw std::runtime_error("Failed to update digest");
+}
+
+void Sha256::final(uint8_t *digest){
+    unsigned int length;
+
+    if(EVP_DigestFinal_ex(_context, digest, &length) != 1 || length != SHA256_LENGTH)
+        throw std::runtime_error("Failed to finalize digest");
+}
+
+size_t Sha256::get_length() const{
+    return SHA256_LENGTH;
+}
+
+Sha256 &Sha256::get_thread_instance(){
+    thread_local Sha256 instance;
+
+    return instance;
+}
+
+std::string Sha256::hex_final(){
+    static const char DIGITS[] = "0123456789abcdef";
+
+    uint8_t digest[SHA256_LENGTH];
+    final(digest);
+
+    std::string output(2*SHA256_LENGTH, '0');
+    for(size_t i = 0; i < SHA256_LENGTH; ++i){
+        output[2*i] = DIGITS[digest[i] >> 4];
+        output[2*i+1] = DIGITS[digest[i] & 0xF];
+    }
+
+    return output;
+}
+
+std::string Sha256::hex_digest(const std::string &data){
+    Sha256 &sha256 = get_thread_instance();
+
+    sha256.begin();
+    sha256.update(data.data(), data.size());
+
+    return sha256.hex_final();
+}
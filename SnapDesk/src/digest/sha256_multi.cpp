@@ -0,0 +1,349 @@
+#include "digest/sha256_multi.hpp"
+
+using namespace digest;
+
+static const uint32_t ROUND_CONSTANTS[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t INITIAL_STATE[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ * @brief Read a big endian 32 bits word
+ *
+ * @param bytes the 4 bytes of the word
+ * @return uint32_t the word
+ */
+static inline uint32_t load_big_endian(const uint8_t *bytes){
+    uint32_t word;
+    memcpy(&word, bytes, sizeof(word));
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return __builtin_bswap32(word);
+#else
+    return word;
+#endif
+}
+
+/**
+ * @brief Rotate a 32 bits word to the right
+ *
+ * @param x the word
+ * @param n the number of bits, from 1 to 31
+ * @return uint32_t the rotated word
+ */
+static inline uint32_t rotate_right(uint32_t x, unsigned n){
+    return (x >> n) | (x << (32 - n));
+}
+
+/**
+ * @brief Compress one block of one message
+ *
+ * @param state the state of the message
+ * @param words the 16 words of the block
+ * @param active all ones to update the state, 0 to keep it
+ */
+static void compress_scalar(uint32_t (*state)[1], const uint32_t (*words)[1], const uint32_t *active){
+    if(!active[0])
+        return;
+
+    uint32_t w[64];
+    for(size_t t = 0; t < 16; ++t)
+        w[t] = words[t][0];
+    for(size_t t = 16; t < 64; ++t){
+        uint32_t s0 = rotate_right(w[t-15], 7) ^ rotate_right(w[t-15], 18) ^ (w[t-15] >> 3);
+        uint32_t s1 = rotate_right(w[t-2], 17) ^ rotate_right(w[t-2], 19) ^ (w[t-2] >> 10);
+        w[t] = w[t-16] + s0 + w[t-7] + s1;
+    }
+
+    uint32_t a = state[0][0], b = state[1][0], c = state[2][0], d = state[3][0];
+    uint32_t e = state[4][0], f = state[5][0], g = state[6][0], h = state[7][0];
+
+    for(size_t t = 0; t < 64; ++t){
+        uint32_t t1 = h + (rotate_right(e, 6) ^ rotate_right(e, 11) ^ rotate_right(e, 25)) + ((e & f) ^ (~e & g)) + ROUND_CONSTANTS[t] + w[t];
+        uint32_t t2 = (rotate_right(a, 2) ^ rotate_right(a, 13) ^ rotate_right(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0][0] += a; state[1][0] += b; state[2][0] += c; state[3][0] += d;
+    state[4][0] += e; state[5][0] += f; state[6][0] += g; state[7][0] += h;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#define ROTATE_AVX2(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+
+/**
+ * @brief Compress one block of 8 messages, one per 32 bits lane of AVX2
+ *
+ * @param state the states of the messages, the word i of the lane j in state[i][j]
+ * @param words the 16 words of the block of each message
+ * @param active all ones for the lanes to update, 0 for the lanes to keep
+ */
+__attribute__((target("avx2")))
+static void compress_avx2(uint32_t (*state)[8], const uint32_t (*words)[8], const uint32_t *active){
+    // The schedule is kept over the last 16 words, the older ones are overwritten as the rounds go
+    __m256i w[16];
+    for(size_t t = 0; t < 16; ++t)
+        w[t] = _mm256_loadu_si256((const __m256i *) words[t]);
+
+    __m256i initial[8];
+    for(size_t i = 0; i < 8; ++i)
+        initial[i] = _mm256_loadu_si256((const __m256i *) state[i]);
+
+    __m256i a = initial[0], b = initial[1], c = initial[2], d = initial[3];
+    __m256i e = initial[4], f = initial[5], g = initial[6], h = initial[7];
+
+#pragma GCC unroll 16
+    for(size_t t = 0; t < 64; ++t){
+        if(t >= 16){
+            __m256i w15 = w[(t-15) & 15], w2 = w[(t-2) & 15];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(ROTATE_AVX2(w15, 7), ROTATE_AVX2(w15, 18)), _mm256_srli_epi32(w15, 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(ROTATE_AVX2(w2, 17), ROTATE_AVX2(w2, 19)), _mm256_srli_epi32(w2, 10));
+            w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0), _mm256_add_epi32(w[(t-7) & 15], s1));
+        }
+
+        __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(ROTATE_AVX2(e, 6), ROTATE_AVX2(e, 11)), ROTATE_AVX2(e, 25));
+        __m256i choice = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(_mm256_add_epi32(h, sigma1), _mm256_add_epi32(choice, w[t & 15])),
+            _mm256_set1_epi32((int) ROUND_CONSTANTS[t]));
+        __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(ROTATE_AVX2(a, 2), ROTATE_AVX2(a, 13)), ROTATE_AVX2(a, 22));
+        __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i t2 = _mm256_add_epi32(sigma0, majority);
+        h = g; g = f; f = e; e = _mm256_add_epi32(d, t1);
+        d = c; c = b; b = a; a = _mm256_add_epi32(t1, t2);
+    }
+
+    // The lanes whose message is over keep their state
+    __m256i mask = _mm256_loadu_si256((const __m256i *) active);
+    __m256i result[8] = {a, b, c, d, e, f, g, h};
+    for(size_t i = 0; i < 8; ++i)
+        _mm256_storeu_si256((__m256i *) state[i], _mm256_blendv_epi8(initial[i], _mm256_add_epi32(initial[i], result[i]), mask));
+}
+
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+
+#define ROTATE_NEON(x, n) vorrq_u32(vshrq_n_u32((x), (n)), vshlq_n_u32((x), 32 - (n)))
+
+/**
+ * @brief Compress one block of 4 messages, one per 32 bits lane of NEON
+ *
+ * @param state the states of the messages, the word i of the lane j in state[i][j]
+ * @param words the 16 words of the block of each message
+ * @param active all ones for the lanes to update, 0 for the lanes to keep
+ */
+static void compress_neon(uint32_t (*state)[4], const uint32_t (*words)[4], const uint32_t *active){
+    uint32x4_t w[64];
+    for(size_t t = 0; t < 16; ++t)
+        w[t] = vld1q_u32(words[t]);
+    for(size_t t = 16; t < 64; ++t){
+        uint32x4_t s0 = veorq_u32(veorq_u32(ROTATE_NEON(w[t-15], 7), ROTATE_NEON(w[t-15], 18)), vshrq_n_u32(w[t-15], 3));
+        uint32x4_t s1 = veorq_u32(veorq_u32(ROTATE_NEON(w[t-2], 17), ROTATE_NEON(w[t-2], 19)), vshrq_n_u32(w[t-2], 10));
+        w[t] = vaddq_u32(vaddq_u32(w[t-16], s0), vaddq_u32(w[t-7], s1));
+    }
+
+    uint32x4_t initial[8];
+    for(size_t i = 0; i < 8; ++i)
+        initial[i] = vld1q_u32(state[i]);
+
+    uint32x4_t a = initial[0], b = initial[1], c = initial[2], d = initial[3];
+    uint32x4_t e = initial[4], f = initial[5], g = initial[6], h = initial[7];
+
+    for(size_t t = 0; t < 64; ++t){
+        uint32x4_t sigma1 = veorq_u32(veorq_u32(ROTATE_NEON(e, 6), ROTATE_NEON(e, 11)), ROTATE_NEON(e, 25));
+        uint32x4_t choice = vbslq_u32(e, f, g);
+        uint32x4_t t1 = vaddq_u32(vaddq_u32(vaddq_u32(h, sigma1), vaddq_u32(choice, w[t])), vdupq_n_u32(ROUND_CONSTANTS[t]));
+        uint32x4_t sigma0 = veorq_u32(veorq_u32(ROTATE_NEON(a, 2), ROTATE_NEON(a, 13)), ROTATE_NEON(a, 22));
+        uint32x4_t majority = vbslq_u32(veorq_u32(a, b), c, b);
+        uint32x4_t t2 = vaddq_u32(sigma0, majority);
+        h = g; g = f; f = e; e = vaddq_u32(d, t1);
+        d = c; c = b; b = a; a = vaddq_u32(t1, t2);
+    }
+
+    // The lanes whose message is over keep their state
+    uint32x4_t mask = vld1q_u32(active);
+    uint32x4_t result[8] = {a, b, c, d, e, f, g, h};
+    for(size_t i = 0; i < 8; ++i)
+        vst1q_u32(state[i], vbslq_u32(mask, vaddq_u32(initial[i], result[i]), initial[i]));
+}
+
+#endif
+
+/* Private */
+
+template<size_t LANES, void (*COMPRESS)(uint32_t (*)[LANES], const uint32_t (*)[LANES], const uint32_t *)>
+void Sha256_multi::_hash_group(const uint8_t *const *messages, const size_t *sizes, size_t count, uint8_t *digests){
+    // The padding of each message is written in its own last one or two blocks
+    uint8_t tails[LANES][2*SHA256_BLOCK];
+    size_t full_blocks[LANES];
+    size_t blocks[LANES];
+    size_t max_blocks = 0;
+
+    for(size_t j = 0; j < LANES; ++j){
+        size_t size = j < count ? sizes[j] : 0;
+        size_t rest = size % SHA256_BLOCK;
+        size_t tail_blocks = rest + 9 <= SHA256_BLOCK ? 1 : 2;
+        uint64_t bit_length = (uint64_t) size * 8;
+
+        memset(tails[j], 0, sizeof(tails[j]));
+        if(rest)
+            memcpy(tails[j], messages[j] + size - rest, rest);
+        tails[j][rest] = 0x80;
+        for(size_t k = 0; k < 8; ++k)
+            tails[j][tail_blocks*SHA256_BLOCK - 1 - k] = (uint8_t) (bit_length >> (8*k));
+
+        full_blocks[j] = size / SHA256_BLOCK;
+        blocks[j] = j < count ? full_blocks[j] + tail_blocks : 0;
+        max_blocks = std::max(max_blocks, blocks[j]);
+    }
+
+    uint32_t state[8][LANES];
+    for(size_t i = 0; i < 8; ++i)
+        for(size_t j = 0; j < LANES; ++j)
+            state[i][j] = INITIAL_STATE[i];
+
+    uint32_t words[16][LANES];
+    uint32_t active[LANES];
+    for(size_t block = 0; block < max_blocks; ++block){
+        // The words of the lane j are the column j, as the lanes of a vector
+        for(size_t j = 0; j < LANES; ++j){
+            active[j] = block < blocks[j] ? 0xFFFFFFFF : 0;
+
+            const uint8_t *data = block < full_blocks[j] ? messages[j] + block*SHA256_BLOCK
+                : tails[j] + (block < blocks[j] ? block - full_blocks[j] : 0)*SHA256_BLOCK;
+            for(size_t t = 0; t < 16; ++t)
+                words[t][j] = load_big_endian(data + 4*t);
+        }
+
+        COMPRESS(state, words, active);
+    }
+
+    for(size_t j = 0; j < count; ++j)
+        for(size_t i = 0; i < 8; ++i){
+            digests[j*SHA256_LENGTH + 4*i] = (uint8_t) (state[i][j] >> 24);
+            digests[j*SHA256_LENGTH + 4*i + 1] = (uint8_t) (state[i][j] >> 16);
+            digests[j*SHA256_LENGTH + 4*i + 2] = (uint8_t) (state[i][j] >> 8);
+            digests[j*SHA256_LENGTH + 4*i + 3] = (uint8_t) state[i][j];
+        }
+}
+
+/* Public */
+
+Sha256_kernel Sha256_multi::get_best_kernel(){
+    static const Sha256_kernel best = is_supported(SHA256_KERNEL_AVX2) ? SHA256_KERNEL_AVX2
+        : is_supported(SHA256_KERNEL_NEON) ? SHA256_KERNEL_NEON : SHA256_KERNEL_SCALAR;
+
+    return best;
+}
+
+bool Sha256_multi::is_supported(Sha256_kernel kernel){
+    switch(kernel){
+    case SHA256_KERNEL_SCALAR:
+        return true;
+    case SHA256_KERNEL_NEON:
+#if defined(__aarch64__) || defined(__ARM_NEON)
+        return true;
+#else
+        return false;
+#endif
+    case SHA256_KERNEL_AVX2:
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+const char *Sha256_multi::get_name(Sha256_kernel kernel){
+    switch(kernel){
+    case SHA256_KERNEL_SCALAR:
+        return "scalar";
+    case SHA256_KERNEL_NEON:
+        return "neon";
+    case SHA256_KERNEL_AVX2:
+        return "avx2";
+    }
+
+    return "unknown";
+}
+
+size_t Sha256_multi::get_lanes(Sha256_kernel kernel){
+    switch(kernel){
+    case SHA256_KERNEL_SCALAR:
+        return 1;
+    case SHA256_KERNEL_NEON:
+        return 4;
+    case SHA256_KERNEL_AVX2:
+        return 8;
+    }
+
+    return 1;
+}
+
+bool Sha256_multi::has_sha_instructions(){
+    static const bool has_them = [](){
+#if defined(__x86_64__) || defined(__i386__)
+        // CPUID leaf 7, bit 29 of EBX
+        unsigned int eax, ebx, ecx, edx;
+        return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1u << 29));
+#elif defined(__aarch64__) && defined(__linux__)
+        return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0;
+#else
+        return false;
+#endif
+    }();
+
+    return has_them;
+}
+
+bool Sha256_multi::is_preferred(){
+    return get_best_kernel() != SHA256_KERNEL_SCALAR && !has_sha_instructions();
+}
+
+void Sha256_multi::digest(const uint8_t *const *messages, const size_t *sizes, size_t count, uint8_t *digests, Sha256_kernel kernel){
+    if(count == 0)
+        return;
+    if(!messages || !sizes || !digests)
+        throw std::invalid_argument("No messages, sizes or digests given");
+    if(!is_supported(kernel))
+        throw std::invalid_argument(std::string("The kernel ") + get_name(kernel) + " is not supported by this processor");
+
+    size_t lanes = get_lanes(kernel);
+
+    for(size_t first = 0; first < count; first += lanes){
+        size_t group = std::min(lanes, count - first);
+
+        switch(kernel){
+        case SHA256_KERNEL_SCALAR:
+            _hash_group<1, compress_scalar>(messages + first, sizes + first, group, digests + first*SHA256_LENGTH);
+            break;
+#if defined(__aarch64__) || defined(__ARM_NEON)
+        case SHA256_KERNEL_NEON:
+            _hash_group<4, compress_neon>(messages + first, sizes + first, group, digests + first*SHA256_LENGTH);
+            break;
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+        case SHA256_KERNEL_AVX2:
+            _hash_group<8, compress_avx2>(messages + first, sizes + first, group, digests + first*SHA256_LENGTH);
+            break;
+#endif
+        default:
+            throw std::invalid_argument(std::string("The kernel ") + get_name(kernel) + " is not compiled in");
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#include "digest/siphash.hpp"
+
+using namespace digest;
+
+static inline uint64_t rotate_left(uint64_t value, int count){
+    return (value << count) | (value >> (64 - count));
+}
+
+static inline uint64_t read_64(const uint8_t *data){
+    uint64_t value = 0;
+    for(size_t i = 0; i < 8; ++i)
+        value |= (uint64_t) data[i] << (8*i);
+    return value;
+}
+
+static inline void write_64(uint8_t *data, uint64_t value){
+    for(size_t i = 0; i < 8; ++i)
+        data[i] = (uint8_t) (value >> (8*i));
+}
+
+/* Constructor */
+
+Siphash::Siphash(const std::string &key, size_t length) : _length(length){
+    if(key.size() != SIPHASH_KEY_LENGTH)
+        throw std::invalid_argument("A SipHash key is " + std::to_string(SIPHASH_KEY_LENGTH) + " bytes long");
+    if(length != 8 && length != 16)
+        throw std::invalid_argument("A SipHash digest is 8 or 16 bytes long");
+
+    _key[0] = read_64((const uint8_t *) key.data());
+    _key[1] = read_64((const uint8_t *) key.data() + 8);
+
+    begin();
+}
+
+/* Private */
+
+void Siphash::_rounds(size_t count){
+    uint64_t v0 = _state[0], v1 = _state[1], v2 = _state[2], v3 = _state[3];
+
+    for(size_t i = 0; i < count; ++i){
+        v0 += v1; v1 = rotate_left(v1, 13); v1 ^= v0; v0 = rotate_left(v0, 32);
+        v2 += v3; v3 = rotate_left(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotate_left(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotate_left(v1, 17); v1 ^= v2; v2 = rotate_left(v2, 32);
+    }
+
+    _state[0] = v0;
+    _state[1] = v1;
+    _state[2] = v2;
+    _state[3] = v3;
+}
+
+void Siphash::_compress(uint64_t block){
+    _state[3] ^= block;
+    _rounds(2);
+    _state[0] ^= block;
+}
+
+/* Public */
+
+void Siphash::begin(){
+    _state[0] = _key[0] ^ 0x736f6d6570736575ULL;
+    _state[1] = _key[1] ^ 0x646f72616e646f6dULL;
+    _state[2] = _key[0] ^ 0x6c7967656e657261ULL;
+    _state[3] = _key[1] ^ 0x7465646279746573ULL;
+
+    if(_length == 16)
+        _state[1] ^= 0xee;
+
+    _buffered = 0;
+    _total = 0;
+}
+
+void Siphash::update(const void *data, size_t size){
+    const uint8_t *input = (const uint8_t *) data;
+
+    _total += size;
+
+    // Complete the waiting block first
+    if(_buffered){
+        size_t count = SIPHASH_BLOCK - _buffered;
+        if(count > size)
+            count = size;
+
+        memcpy(_buffer + _buffered, input, count);
+        _buffered += count;
+        input += count;
+        size -= count;
+
+        if(_buffered < SIPHASH_BLOCK)
+            return;
+
+        _compress(read_64(_buffer));
+        _buffered = 0;
+    }
+
+    for(; size >= SIPHASH_BLOCK; input += SIPHASH_BLOCK, size -= SIPHASH_BLOCK)
+        _compress(read_64(input));
+
+    memcpy(_buffer, input, size);
+    _buffered = size;
+}
+
+void Siphash::final(uint8_t *digest){
+    // The last block holds the remaining bytes and the low byte of the length
+    uint64_t block = _total << 56;
+    for(size_t i = 0; i < _buffered; ++i)
+        block |= (uint64_t) _buffer[i] << (8*i);
+
+    _compress(block);
+
+    _state[2] ^= _length == 16 ? 0xee : 0xff;
+    _rounds(4);
+    write_64(digest, _state[0] ^ _state[1] ^ _state[2] ^ _state[3]);
+
+    if(_length == 16){
+        _state[1] ^= 0xdd;
+        _rounds(4);
+        write_64(digest + 8, _state[0] ^ _state[1] ^ _state[2] ^ _state[3]);
+    }
+}
+
+size_t Siphash::get_length() const{
+    return _length;
+}
@@ -0,0 +1,191 @@
+#include "digest/xxh64.hpp"
+
+using namespace digest;
+
+static const uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+// The second seed of Xxh128, any value far from 0 fits
+static const uint64_t XXH128_SEED = PRIME_5;
+
+static inline uint64_t rotate_left(uint64_t value, int count){
+    return (value << count) | (value >> (64 - count));
+}
+
+static inline uint64_t read_64(const uint8_t *data){
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+static inline uint32_t read_32(const uint8_t *data){
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+static inline uint64_t lane_round(uint64_t lane, uint64_t input){
+    lane += input * PRIME_2;
+    lane = rotate_left(lane, 31);
+    return lane * PRIME_1;
+}
+
+static inline uint64_t merge_round(uint64_t hash, uint64_t lane){
+    hash ^= lane_round(0, lane);
+    return hash * PRIME_1 + PRIME_4;
+}
+
+static void write_big_endian(uint8_t *digest, uint64_t value){
+    for(size_t i = 0; i < 8; ++i)
+        digest[i] = (uint8_t) (value >> (56 - 8*i));
+}
+
+/* Constructor */
+
+Xxh64::Xxh64(uint64_t seed) : _seed(seed){
+    begin();
+}
+
+Xxh128::Xxh128() : _high(0), _low(XXH128_SEED){
+}
+
+/* Private */
+
+void Xxh64::_consume(uint64_t *lanes, const uint8_t *data, size_t count){
+    // The four lanes do not depend on each other, so their multiplications run in parallel
+    uint64_t lane_1 = lanes[0], lane_2 = lanes[1], lane_3 = lanes[2], lane_4 = lanes[3];
+
+    for(size_t i = 0; i < count; ++i, data += XXH64_STRIPE){
+        lane_1 = lane_round(lane_1, read_64(data));
+        lane_2 = lane_round(lane_2, read_64(data + 8));
+        lane_3 = lane_round(lane_3, read_64(data + 16));
+        lane_4 = lane_round(lane_4, read_64(data + 24));
+    }
+
+    lanes[0] = lane_1;
+    lanes[1] = lane_2;
+    lanes[2] = lane_3;
+    lanes[3] = lane_4;
+}
+
+/* Public */
+
+void Xxh64::begin(){
+    _lanes[0] = _seed + PRIME_1 + PRIME_2;
+    _lanes[1] = _seed + PRIME_2;
+    _lanes[2] = _seed;
+    _lanes[3] = _seed - PRIME_1;
+    _buffered = 0;
+    _total = 0;
+}
+
+void Xxh64::update(const void *data, size_t size){
+    const uint8_t *input = (const uint8_t *) data;
+
+    _total += size;
+
+    // Complete the waiting stripe first
+    if(_buffered){
+        size_t count = XXH64_STRIPE - _buffered;
+        if(count > size)
+            count = size;
+
+        memcpy(_buffer + _buffered, input, count);
+        _buffered += count;
+        input += count;
+        size -= count;
+
+        if(_buffered < XXH64_STRIPE)
+            return;
+
+        _consume(_lanes, _buffer, 1);
+        _buffered = 0;
+    }
+
+    size_t stripes = size / XXH64_STRIPE;
+    if(stripes){
+        _consume(_lanes, input, stripes);
+        input += stripes * XXH64_STRIPE;
+        size -= stripes * XXH64_STRIPE;
+    }
+
+    memcpy(_buffer, input, size);
+    _buffered = size;
+}
+
+uint64_t Xxh64::final_value() const{
+    uint64_t hash;
+
+    if(_total >= XXH64_STRIPE){
+        hash = rotate_left(_lanes[0], 1) + rotate_left(_lanes[1], 7) + rotate_left(_lanes[2], 12) + rotate_left(_lanes[3], 18);
+        for(size_t i = 0; i < 4; ++i)
+            hash = merge_round(hash, _lanes[i]);
+    } else {
+        hash = _seed + PRIME_5;
+    }
+
+    hash += _total;
+
+    const uint8_t *tail = _buffer;
+    size_t remaining = _buffered;
+
+    for(; remaining >= 8; tail += 8, remaining -= 8){
+        hash ^= lane_round(0, read_64(tail));
+        hash = rotate_left(hash, 27) * PRIME_1 + PRIME_4;
+    }
+    if(remaining >= 4){
+        hash ^= (uint64_t) read_32(tail) * PRIME_1;
+        hash = rotate_left(hash, 23) * PRIME_2 + PRIME_3;
+        tail += 4;
+        remaining -= 4;
+    }
+    for(; remaining > 0; ++tail, --remaining){
+        hash ^= *tail * PRIME_5;
+        hash = rotate_left(hash, 11) * PRIME_1;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+void Xxh64::final(uint8_t *digest){
+    write_big_endian(digest, final_value());
+}
+
+size_t Xxh64::get_length() const{
+    return XXH64_LENGTH;
+}
+
+void Xxh128::begin(){
+    _high.begin();
+    _low.begin();
+}
+
+void Xxh128::update(const void *data, size_t size){
+    _high.update(data, size);
+    _low.update(data, size);
+}
+
+void Xxh128::final(uint8_t *digest){
+    _high.final(digest);
+    _low.final(digest + XXH64_LENGTH);
+}
+
+size_t Xxh128::get_length() const{
+    return XXH128_LENGTH;
+}
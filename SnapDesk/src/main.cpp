@@ -11,84 +11,228 @@
 
 #include "decoder/frame.hpp"
 #include "os_communicator/os_communicator.hpp"
-#include "compiler/node.hpp"
-#include "compiler/function_node.hpp"
-#include "compiler/compiler.hpp"
+#include "compiler/compiled_scripts.hpp"
 #include "database/core.hpp"
+#include "os_communicator/trace_ring.hpp"
+#include "os_communicator/file_watcher.hpp"
+
+#include <memory>
+#include <thread>
 
 // Args values (to determine how to get them afteward)
 #define CHARACTER_DEVICE_FILE "/dev/beacon-sniffer-0"
 #define SCRIPT_FILE "./code.txt"
 #define PERIOD 1
 
+/**
+ * @brief Write the trace of the current frame if tracing is enabled
+ * 
+ * @param trace the trace ring, or nullptr if tracing is disabled
+ * @param frame the current frame
+ * @param verdict the verdict of the validation of the frame
+ * @param reason the reason of the verdict
+ * @param outputs the outputs of the evaluation, one per script and per Output block, written separated by spaces
+ */
+void trace_frame(os_communicator::Trace_ring *trace, const decoder::Frame *frame, decoder::Verdict verdict, decoder::Validation_reason reason, const std::vector<std::string> &outputs){
+    if(!trace)
+        return;
+
+    size_t size;
+    const uint8_t *raw_frame = frame->get_raw_data(size);
+
+    if(outputs.size() == 1){
+        trace->write(raw_frame, size, verdict, reason, outputs[0]);
+        return;
+    }
+
+    std::string output = "";
+    for(size_t i = 0; i < outputs.size(); ++i)
+        output += (i ? " " : "") + outputs[i];
+
+    trace->write(raw_frame, size, verdict, reason, output);
+}
+
+/**
+ * @brief The scripts currently run, replaced by reload_scripts() when they change
+ * 
+ * Only std::atomic_load() and std::atomic_store() access it, the main loop keeps its own reference
+ * until the end of the frame, so a program is never destroyed while it runs.
+ */
+static std::shared_ptr<compiler::Compiled_scripts> loaded_scripts;
+
+/**
+ * @brief Compile the scripts again each time one of them is written, and publish them for the next frame
+ * 
+ * @param scripts the paths of the scripts
+ * @param is_profiling true to record the profile of the new scripts
+ */
+void reload_scripts(std::vector<std::string> scripts, bool is_profiling){
+    try{
+        os_communicator::File_watcher watcher(scripts);
+
+        while(1){
+            watcher.wait();
+
+            // On failure the scripts in use are kept, the next write is another try
+            try{
+                std::shared_ptr<compiler::Compiled_scripts> compiled = std::make_shared<compiler::Compiled_scripts>(scripts, is_profiling);
+                std::shared_ptr<compiler::Compiled_scripts> current = std::atomic_load(&loaded_scripts);
+
+                if(current && current->get_hashes() == compiled->get_hashes())
+                    continue;
+
+                compiled->print();
+                std::atomic_store(&loaded_scripts, compiled);
+                printf("The scripts have been reloaded\n");
+            } catch(const std::exception &e){
+                fprintf(stderr, "Reload failed, the previous scripts are kept: %s\n", e.what());
+            }
+        }
+    } catch(const std::exception &e){
+        fprintf(stderr, "The scripts will not be reloaded: %s\n", e.what());
+    }
+}
+
 /**
  * @brief The true main function. This exist to permit the program to rerun itself when crashing
  * 
+ * @param trace the ring where each frame is traced, or nullptr
+ * @param scripts the paths of the scripts, each one has its own databases
+ * @param is_profiling true to record the profile of the scripts, printed on SIGUSR1 and on SIGINT
  * @return int: The same return than the main function
  */
-int run(){
+int run(os_communicator::Trace_ring *trace, const std::vector<std::string> &scripts, bool is_profiling){
     os_communicator::Communicator::create_folder(DATABASE_ROOT);
 
+    // A single script was the only script before, its databases were written in the legacy folder
+    if(scripts.size() == 1)
+        database::Database::adopt_legacy_folder(scripts[0]);
+
+    std::shared_ptr<compiler::Compiled_scripts> compiled = std::atomic_load(&loaded_scripts);
+    if(!compiled){
+        compiled = std::make_shared<compiler::Compiled_scripts>(scripts, is_profiling);
+        compiled->print();
+        std::atomic_store(&loaded_scripts, compiled);
+    }
+
     os_communicator::Communicator *c_frame = new os_communicator::Communicator(CHARACTER_DEVICE_FILE);
-    os_communicator::Communicator *c_script = new os_communicator::Communicator(SCRIPT_FILE);
     decoder::Frame *beacon_frame = new decoder::Frame(c_frame);
 
-    compiler::Compiler *compiler = new compiler::Compiler(c_script);
-    executable_tree::Node *tree = compiler->get_executable_tree();
-    printf("----- tree -----\n");
-    printf("%s", tree->to_string(0).c_str());
-    printf("----------------\n");
-
-    database::Database *database = nullptr;  
+    std::vector<database::Database *> databases(scripts.size(), nullptr);
     std::string current_ssid = "";
 
+    // kill -USR1 prints the statistics and the hit rate of the cache
+    decoder::Validator validator;
+    os_communicator::Communicator::watch_signal(SIGUSR1);
+    if(is_profiling)
+        os_communicator::Communicator::watch_signal(SIGINT);
+
     try{
         while(1){
             os_communicator::Communicator::sleep(PERIOD);
 
+            // New scripts are taken between two frames, their outputs go to the folder of their hash
+            std::shared_ptr<compiler::Compiled_scripts> current = std::atomic_load(&loaded_scripts);
+            if(current != compiled){
+                compiled->print_profile();
+                compiled = current;
+                for(database::Database *&database : databases){
+                    delete database;
+                    database = nullptr;
+                }
+            }
+
+            if(os_communicator::Communicator::signal_received(SIGUSR1)){
+                validator.print();
+                compiled->get_cache()->print();
+                compiled->print_filters();
+                compiled->print_profile();
+            }
+
+            // With a profile, Ctrl-C prints it before leaving
+            if(is_profiling && os_communicator::Communicator::signal_received(SIGINT)){
+                compiled->print_profile();
+                delete beacon_frame;
+                delete c_frame;
+                for(database::Database *database : databases)
+                    delete database;
+
+                return 0;
+            }
+
             beacon_frame->update_raw_data();
 
             //beacon_frame->print_raw_data();
 
+            decoder::Verdict verdict = beacon_frame->validate(validator);
+            decoder::Validation_reason reason = beacon_frame->get_validation_reason();
+
+            if(verdict == decoder::VERDICT_DROP){
+                trace_frame(trace, beacon_frame, verdict, reason, {});
+                continue;
+            }
+
+            // A frame skipped by the Filter and Require blocks of every script is not decoded
+            if(!compiled->filter(beacon_frame)){
+                trace_frame(trace, beacon_frame, verdict, reason, {});
+                continue;
+            }
+
             beacon_frame->decode();
 
-            beacon_frame->print();
+            const std::vector<std::string> &outputs = compiled->run(beacon_frame);
 
-            std::string output = tree->get_value(beacon_frame);
+            trace_frame(trace, beacon_frame, verdict, reason, outputs);
 
-            if(beacon_frame->get_value("0").is_null())
+            // Hidden SSID
+            if(beacon_frame->get_value("0").is_null() || beacon_frame->get_value("0").char_string() == "")
                 continue;
 
             if(beacon_frame->get_value("0").char_string() != current_ssid){
                 current_ssid = beacon_frame->get_value("0").char_string();
-                delete database;
-                database = nullptr;
+                for(database::Database *&database : databases){
+                    delete database;
+                    database = nullptr;
+                }
             }
 
-            if(database == nullptr)
-                database = new database::Database(beacon_frame->get_value("0").char_string(), "snappy.txt");
+            // Each script has its own databases, in the folder of its path and hash
+            bool is_new = false;
+            for(size_t i = 0; i < scripts.size(); ++i){
+                if(!compiled->is_accepted(i))
+                    continue;
 
-            if(database->get_key_of_entries("output", output).empty()){
-                database->add_entry({
-                    output, 
-                    os_communicator::Communicator::get_current_date(), 
-                    os_communicator::Communicator::get_current_date()});
-                os_communicator::Communicator::notify("A new AP as been detected on SSID: " + current_ssid);
+                // The output is the key, the values of the Output blocks are the columns next to it
+                size_t position = compiled->get_output_position(i);
+                const std::vector<std::string> &output_names = compiled->get_output_names()[i];
+                const std::string &output = outputs[position];
+                std::vector<std::string> values(outputs.begin() + position, outputs.begin() + position + 1 + output_names.size());
+
+                if(databases[i] == nullptr)
+                    databases[i] = new database::Database(current_ssid, scripts[i], compiled->get_hashes()[i], output_names);
+                database::Database *database = databases[i];
+
+                if(database->get_key_of_entries("output", output).empty()){
+                    values.push_back(os_communicator::Communicator::get_current_date());
+                    values.push_back(os_communicator::Communicator::get_current_date());
+                    database->add_entry(values);
+                    is_new = true;
+                }
+                else {
+                    values.push_back(database->get_cell(output, "creation_date"));
+                    values.push_back(os_communicator::Communicator::get_current_date());
+                    database->replace_entry(output, values);
+                }
             }
-            else
-                database->replace_entry(output, {
-                    output, 
-                    database->get_cell(output, "creation_date"),
-                    os_communicator::Communicator::get_current_date()});
 
+            if(is_new)
+                os_communicator::Communicator::notify("A new AP as been detected on SSID: " + current_ssid);
         }
     } catch(const std::exception &e){
         delete beacon_frame;
         delete c_frame;
-        delete c_script;
-        delete compiler;
-        delete tree;
-        delete database;
+        for(database::Database *database : databases)
+            delete database;
 
         throw;
     }
@@ -97,9 +241,49 @@ int run(){
 }
 
 int main(int argc, char *argv[]) {
+    // snapdesk [--trace <file>] [--profile] [--plan] [script ...]
+    os_communicator::Trace_ring *trace = nullptr;
+    std::vector<std::string> scripts;
+    bool is_profiling = false;
+    bool is_planning = false;
+
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+
+        if(arg == "--trace" && i+1 < argc){
+            trace = os_communicator::Trace_ring::create(argv[++i], TRACE_DEFAULT_SLOTS);
+        } else if(arg == "--profile"){
+            is_profiling = true;
+        } else if(arg == "--plan"){
+            is_planning = true;
+        } else if(!arg.empty() && arg[0] != '-'){
+            scripts.push_back(arg);
+        } else {
+            fprintf(stderr, "Usage: %s [--trace <file>] [--profile] [--plan] [script ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if(scripts.empty())
+        scripts.push_back(SCRIPT_FILE);
+
+    // Only print what the scripts compile to, without capturing
+    if(is_planning){
+        try{
+            compiler::Compiled_scripts(scripts, false, false).print();
+        } catch(const std::exception &e){
+            fprintf(stderr, "Error: %s\n", e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    // The scripts are watched for the whole life of the process, even when run() restarts
+    std::thread(reload_scripts, scripts, is_profiling).detach();
+
     while (true){
         try{
-            run();
+            return run(trace, scripts, is_profiling);
         }
         catch(const std::exception &e){
             fprintf(stderr, "Error: %s\n", e.what());
@@ -109,4 +293,4 @@ int main(int argc, char *argv[]) {
         }
         os_communicator::Communicator::sleep(PERIOD);
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,76 @@
+#include "os_communicator/file_watcher.hpp"
+
+using namespace std;
+
+namespace os_communicator
+{
+    /* Constructor */
+
+    File_watcher::File_watcher(const vector<string> &file_names){
+        _file_descriptor = inotify_init1(IN_CLOEXEC);
+        if(_file_descriptor < 0)
+            throw runtime_error("Failed to create an inotify instance");
+
+        for(const string &file_name : file_names){
+            size_t separator = file_name.rfind('/');
+            string directory = separator == string::npos ? "." : file_name.substr(0, separator + 1);
+            string name = separator == string::npos ? file_name : file_name.substr(separator + 1);
+
+            // A directory watched twice gives the same watch descriptor
+            int watch = inotify_add_watch(_file_descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if(watch < 0){
+                close(_file_descriptor);
+                throw runtime_error("Failed to watch the directory of " + file_name);
+            }
+
+            _files.push_back({watch, name});
+        }
+    }
+
+    File_watcher::~File_watcher(){
+        close(_file_descriptor);
+    }
+
+    /* Public */
+
+    void File_watcher::wait(){
+        alignas(struct inotify_event) char buffer[4096];
+        bool is_modified = false;
+        int timeout = -1;
+
+        // Wait for the first event on a file, then until the events stop
+        while(true){
+            struct pollfd descriptor = {_file_descriptor, POLLIN, 0};
+            int ready = poll(&descriptor, 1, timeout);
+
+            // A signal handled by watch_signal() may be delivered to this thread, the wait goes on
+            if(ready < 0 && errno == EINTR)
+                continue;
+            if(ready < 0)
+                throw runtime_error("Failed to wait for inotify events");
+            if(ready == 0)
+                return;
+
+            ssize_t length = read(_file_descriptor, buffer, sizeof(buffer));
+            if(length < 0 && errno == EINTR)
+                continue;
+            if(length <= 0)
+                throw runtime_error("Failed to read inotify events");
+
+            for(ssize_t offset = 0; offset < length;){
+                const struct inotify_event *event = (const struct inotify_event *) (buffer + offset);
+                offset += sizeof(struct inotify_event) + event->len;
+
+                if(event->len == 0)
+                    continue;
+
+                for(const pair<int, string> &file : _files)
+                    if(file.first == event->wd && file.second == event->name)
+                        is_modified = true;
+            }
+
+            if(is_modified)
+                timeout = FILE_WATCHER_SETTLE_MS;
+        }
+    }
+}
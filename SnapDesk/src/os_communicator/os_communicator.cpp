@@ -4,6 +4,17 @@ using namespace std;
 
 namespace os_communicator
 {
+    static volatile sig_atomic_t received_signals[NSIG] = {}; ///<1 for each watched signal received
+
+    /**
+     * @brief Record the reception of a watched signal
+     * 
+     * @param signal_number the received signal
+     */
+    static void on_signal(int signal_number){
+        received_signals[signal_number] = 1;
+    }
+
     /* Constructor */
 
     Communicator::Communicator(string file_name) : _file_name(file_name) {};
@@ -75,6 +86,29 @@ namespace os_communicator
         return "";
     }
 
+    string Communicator::get_content() const {
+        std::ifstream file(_file_name, std::ifstream::binary);
+
+        if (!file.is_open()) {
+            throw runtime_error("Failed to open file: " + _file_name);
+        }
+
+        string content;
+        file.seekg(0, std::ifstream::end);
+        std::streamoff size = file.tellg();
+        file.seekg(0, std::ifstream::beg);
+
+        if(size > 0){
+            content.resize((size_t) size);
+            file.read(&content[0], size);
+            content.resize((size_t) file.gcount());
+        }
+
+        file.close();
+
+        return content;
+    }
+
     void Communicator::add_line(string line){
         std::ofstream file(_file_name, std::fstream::out | std::fstream::app);
 
@@ -137,6 +171,43 @@ namespace os_communicator
         file.close();
     }
 
+    void Communicator::replace_content(const string &content){
+        string temporary_name = _file_name + "." + to_string(getpid()) + ".tmp";
+        std::ofstream file(temporary_name, std::fstream::out | std::fstream::binary | std::fstream::trunc);
+
+        if (!file.is_open()) {
+            throw runtime_error("Failed to open file: " + temporary_name);
+        }
+
+        file << content;
+        file.close();
+
+        error_code error;
+        if(!file.fail())
+            filesystem::rename(temporary_name, _file_name, error);
+
+        if(file.fail() || error){
+            filesystem::remove(temporary_name, error);
+            throw runtime_error("Failed to replace file: " + _file_name);
+        }
+    }
+
+    void Communicator::rename_to(string new_name){
+        error_code error;
+        filesystem::rename(_file_name, new_name, error);
+
+        if(error)
+            throw runtime_error("Failed to rename file: " + _file_name + " to " + new_name);
+    }
+
+    void Communicator::remove(){
+        error_code error;
+        filesystem::remove(_file_name, error);
+
+        if(error)
+            throw runtime_error("Failed to remove file: " + _file_name);
+    }
+
     string Communicator::get_current_date(){
         std::time_t time = std::time(nullptr);
         std::tm tm = *std::localtime(&time);
@@ -154,6 +225,31 @@ namespace os_communicator
         std::this_thread::sleep_for(std::chrono::seconds(seconds));
     }
 
+    void Communicator::watch_signal(int signal_number){
+        if(signal_number <= 0 || signal_number >= NSIG)
+            throw invalid_argument("Invalid signal " + to_string(signal_number));
+
+        struct sigaction action = {};
+        action.sa_handler = on_signal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+
+        if(sigaction(signal_number, &action, nullptr) != 0)
+            throw runtime_error("Failed to watch signal " + to_string(signal_number));
+    }
+
+    bool Communicator::signal_received(int signal_number){
+        if(signal_number <= 0 || signal_number >= NSIG)
+            throw invalid_argument("Invalid signal " + to_string(signal_number));
+
+        if(!received_signals[signal_number])
+            return false;
+
+        received_signals[signal_number] = 0;
+
+        return true;
+    }
+
     void Communicator::create_folder(string folder_name){
         if(Communicator::get_file_type(folder_name) == F_FILE)
             throw runtime_error("The file " + folder_name + " must be a folder");
@@ -0,0 +1,155 @@
+#include "os_communicator/replay.hpp"
+
+using namespace std;
+
+namespace os_communicator
+{
+    /**
+     * @brief Read a 16 or 32 bits number from a pcap file
+     * 
+     * @param buffer the buffer containing the number
+     * @param size the size of the number (2 or 4)
+     * @param swapped true if the file has not the byte order of the host
+     * @return uint32_t the number
+     */
+    static uint32_t read_number(const uint8_t *buffer, size_t size, bool swapped){
+        uint32_t value = 0;
+
+        for(size_t i = 0; i < size; ++i){
+            size_t shift = swapped ? 8*(size-1-i) : 8*i;
+            value |= ((uint32_t) buffer[i]) << shift;
+        }
+
+        return value;
+    }
+
+    /* Constructor */
+
+    Replay::Replay(string file_name){
+        ifstream file(file_name, ios::binary);
+
+        if(!file.is_open())
+            throw runtime_error("Failed to open file: " + file_name);
+
+        vector<uint8_t> content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+        file.close();
+
+        if(content.size() < PCAP_GLOBAL_HEADER_SIZE)
+            throw runtime_error("The file " + file_name + " is not a pcap file");
+
+        // Magic number, microsecond or nanosecond, in one byte order or the other
+        uint32_t magic = read_number(content.data(), 4, false);
+        bool swapped;
+
+        if(magic == 0xA1B2C3D4 || magic == 0xA1B23C4D)
+            swapped = false;
+        else if(magic == 0xD4C3B2A1 || magic == 0x4D3CB2A1)
+            swapped = true;
+        else
+            throw runtime_error("The file " + file_name + " is not a pcap file");
+
+        uint32_t link_type = read_number(content.data()+20, 4, swapped);
+
+        if(link_type != LINKTYPE_IEEE802_11 && link_type != LINKTYPE_IEEE802_11_RADIOTAP)
+            throw runtime_error("Unsupported link type " + to_string(link_type) + " in " + file_name);
+
+        size_t cursor = PCAP_GLOBAL_HEADER_SIZE;
+
+        while(cursor + PCAP_RECORD_HEADER_SIZE <= content.size()){
+            size_t captured_length = read_number(content.data()+cursor+8, 4, swapped);
+            cursor += PCAP_RECORD_HEADER_SIZE;
+
+            if(cursor + captured_length > content.size())
+                break;
+
+            const uint8_t *record = content.data()+cursor;
+            cursor += captured_length;
+
+            if(link_type == LINKTYPE_IEEE802_11){
+                _add_frame(record, captured_length, true);
+                continue;
+            }
+
+            // Radiotap header: version, pad, length (little endian), present flags
+            if(captured_length < 8)
+                continue;
+
+            size_t radiotap_length = record[2] | (record[3] << 8);
+            uint32_t present = read_number(record+4, 4, false);
+
+            if(radiotap_length > captured_length)
+                continue;
+
+            // The present words are chained by their bit 31, a chain running past the header is malformed
+            size_t fields_position = 8;
+            bool is_malformed = false;
+            for(uint32_t p = present; p & 0x80000000; fields_position += 4){
+                if(fields_position + 4 > radiotap_length){
+                    is_malformed = true;
+                    break;
+                }
+                p = read_number(record+fields_position, 4, false);
+            }
+            if(is_malformed)
+                continue;
+
+            // The flags field is the second one, after the TSFT (8 bytes aligned on 8) if present
+            bool has_fcs = false;
+            if(present & 0x2){
+                size_t flags_position = fields_position;
+                if(present & 0x1)
+                    flags_position = ((flags_position + 7) & ~((size_t) 7)) + 8;
+                if(flags_position < radiotap_length)
+                    has_fcs = record[flags_position] & RADIOTAP_FLAGS_FCS;
+            }
+
+            _add_frame(record+radiotap_length, captured_length-radiotap_length, has_fcs);
+        }
+
+        // Pointers are taken once all frames are in place, _frames may have moved before
+        size_t position = 0;
+        for(size_t frame_size : _frame_sizes){
+            _frame_pointers.push_back(_frames.data()+position);
+            position += frame_size;
+        }
+    }
+
+    Replay::Replay(const vector<vector<uint8_t>> &frames){
+        for(const vector<uint8_t> &frame : frames)
+            _add_frame(frame.data(), frame.size(), true);
+
+        size_t position = 0;
+        for(size_t frame_size : _frame_sizes){
+            _frame_pointers.push_back(_frames.data()+position);
+            position += frame_size;
+        }
+    }
+
+    /* Private */
+
+    void Replay::_add_frame(const uint8_t *frame, size_t size, bool has_fcs){
+        _frames.insert(_frames.end(), frame, frame+size);
+
+        if(!has_fcs){
+            _frames.insert(_frames.end(), 4, 0);
+            size += 4;
+        }
+
+        _frame_sizes.push_back(size);
+    }
+
+    /* Public */
+
+    size_t Replay::size() const {
+        return _frame_sizes.size();
+    }
+
+    const uint8_t *const *Replay::get_frames() const {
+        return _frame_pointers.data();
+    }
+
+    const size_t *Replay::get_sizes() const {
+        return _frame_sizes.data();
+    }
+}
@@ -0,0 +1,139 @@
+#include "os_communicator/trace_ring.hpp"
+
+using namespace std;
+
+namespace os_communicator
+{
+    /* Private */
+
+    void Trace_ring::_map(bool writable){
+        int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        void *mapping = mmap(nullptr, _mapped_size, protection, MAP_SHARED, _file_descriptor, 0);
+
+        if(mapping == MAP_FAILED){
+            close(_file_descriptor);
+            throw runtime_error("Failed to map the trace file");
+        }
+
+        _header = (Trace_header *) mapping;
+        _slots = (Trace_slot *) ((uint8_t *) mapping + sizeof(Trace_header));
+    }
+
+    /* Constructor */
+
+    Trace_ring::Trace_ring(int file_descriptor, size_t mapped_size) 
+    : _file_descriptor(file_descriptor), _mapped_size(mapped_size) {
+        _map(true);
+    }
+
+    Trace_ring::Trace_ring(string file_name){
+        _file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+
+        if(_file_descriptor < 0)
+            throw runtime_error("Failed to open file: " + file_name);
+
+        struct stat status;
+        if(fstat(_file_descriptor, &status) != 0 || (size_t) status.st_size < sizeof(Trace_header)){
+            close(_file_descriptor);
+            throw runtime_error("The file " + file_name + " is not a trace file");
+        }
+
+        _mapped_size = status.st_size;
+        _map(false);
+
+        bool is_valid = memcmp(_header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) == 0
+            && _header->version == TRACE_VERSION
+            && _header->slot_size == sizeof(Trace_slot)
+            && _header->slot_count > 0
+            && _mapped_size >= sizeof(Trace_header) + _header->slot_count * sizeof(Trace_slot);
+
+        if(!is_valid){
+            munmap(_header, _mapped_size);
+            close(_file_descriptor);
+            throw runtime_error("The file " + file_name + " is not a trace file of this version");
+        }
+    }
+
+    Trace_ring::~Trace_ring(){
+        munmap(_header, _mapped_size);
+        close(_file_descriptor);
+    }
+
+    Trace_ring *Trace_ring::create(string file_name, size_t slot_count){
+        if(slot_count == 0)
+            throw invalid_argument("A trace ring needs at least one slot");
+
+        int file_descriptor = ::open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+        if(file_descriptor < 0)
+            throw runtime_error("Failed to open file: " + file_name);
+
+        size_t size = sizeof(Trace_header) + slot_count * sizeof(Trace_slot);
+
+        if(ftruncate(file_descriptor, size) != 0){
+            close(file_descriptor);
+            throw runtime_error("Failed to resize file: " + file_name);
+        }
+
+        Trace_ring *ring = new Trace_ring(file_descriptor, size);
+
+        // The file is full of zeros: every slot is empty
+        memcpy(ring->_header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        ring->_header->version = TRACE_VERSION;
+        ring->_header->slot_count = slot_count;
+        ring->_header->slot_size = sizeof(Trace_slot);
+
+        return ring;
+    }
+
+    /* Public */
+
+    void Trace_ring::write(const uint8_t *frame, size_t frame_size, uint8_t verdict, uint8_t reason, const string &output){
+        uint64_t index = _header->write_index.fetch_add(1, memory_order_relaxed);
+        Trace_slot &slot = _slots[index % _header->slot_count];
+
+        slot.sequence.store(2*index + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+
+        slot.timestamp = now.tv_sec * 1000000000ull + now.tv_nsec;
+        slot.frame_size = min(frame_size, sizeof(slot.frame));
+        slot.output_size = min(output.size(), sizeof(slot.output));
+        slot.verdict = verdict;
+        slot.reason = reason;
+        if(frame)
+            memcpy(slot.frame, frame, slot.frame_size);
+        memcpy(slot.output, output.data(), slot.output_size);
+
+        slot.sequence.store(2*index + 2, memory_order_release);
+    }
+
+    uint64_t Trace_ring::get_write_index() const {
+        return _header->write_index.load(memory_order_acquire);
+    }
+
+    size_t Trace_ring::get_slot_count() const {
+        return _header->slot_count;
+    }
+
+    bool Trace_ring::read(uint64_t index, Trace_record &record) const {
+        const Trace_slot &slot = _slots[index % _header->slot_count];
+
+        if(slot.sequence.load(memory_order_acquire) != 2*index + 2)
+            return false;
+
+        record.index = index;
+        record.timestamp = slot.timestamp;
+        record.verdict = slot.verdict;
+        record.reason = slot.reason;
+        record.frame.assign(slot.frame, slot.frame + min((size_t) slot.frame_size, sizeof(slot.frame)));
+        record.output.assign(slot.output, min((size_t) slot.output_size, sizeof(slot.output)));
+
+        // The slot may have been rewritten while copying it
+        atomic_thread_fence(memory_order_acquire);
+
+        return slot.sequence.load(memory_order_relaxed) == 2*index + 2;
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * @file codegen.cpp
+ * @author Pagano Florian
+ * @brief snapdesk-codegen: compile a script to the C++ translation unit linked by make aot
+ * @version 0.1
+ * @date 2025
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Usage: snapdesk-codegen <script> <output.cpp>
+ *
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "os_communicator/os_communicator.hpp"
+#include "compiler/compiler.hpp"
+
+int main(int argc, char *argv[]){
+    if(argc != 3){
+        fprintf(stderr, "Usage: %s <script> <output.cpp>\n", argv[0]);
+        return 1;
+    }
+
+    os_communicator::Communicator *c_script = nullptr;
+    compiler::Compiler *compiler = nullptr;
+    executable_tree::Node *tree = nullptr;
+    bytecode::Program *program = nullptr;
+    int status = 0;
+
+    try{
+        c_script = new os_communicator::Communicator(argv[1]);
+        compiler = new compiler::Compiler(c_script);
+        tree = compiler->get_executable_tree();
+        program = compiler->get_program(tree);
+
+        std::string source = compiler->get_native_source(program);
+
+        std::ofstream file(argv[2], std::ofstream::out | std::ofstream::trunc);
+        if(!file.is_open())
+            throw std::runtime_error("Failed to open file: " + std::string(argv[2]));
+
+        file << source;
+        file.close();
+
+        printf("%s: %s compiled to %s\n", compiler->get_hash().c_str(), argv[1], argv[2]);
+    } catch(const std::exception &e){
+        fprintf(stderr, "Error: %s\n", e.what());
+        status = 1;
+    }
+
+    delete program;
+    delete tree;
+    delete compiler;
+    delete c_script;
+
+    return status;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file trace.cpp
+ * @author Pagano Florian
+ * @brief snapdesk-trace: decode and print the frames traced by snapdesk, out of the hot path
+ * @version 0.1
+ * @date 2025
+ * 
+ * @copyright Copyright (c) 2025
+ * 
+ * Usage: snapdesk-trace <trace file> [count]
+ * 
+ */
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <algorithm>
+
+#include "decoder/frame.hpp"
+#include "decoder/validator.hpp"
+#include "os_communicator/trace_ring.hpp"
+
+/**
+ * @brief Format a timestamp in ns since epoch as a readable date
+ * 
+ * @param timestamp the timestamp
+ * @return std::string the date
+ */
+std::string format_timestamp(uint64_t timestamp){
+    time_t seconds = timestamp / 1000000000;
+    struct tm date;
+    localtime_r(&seconds, &date);
+
+    char buffer[64];
+    size_t length = strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &date);
+    snprintf(buffer + length, sizeof(buffer) - length, ".%06lu", (unsigned long) (timestamp % 1000000000) / 1000);
+
+    return buffer;
+}
+
+/**
+ * @brief Decode and print one traced frame
+ * 
+ * @param record the trace of the frame
+ */
+void print_record(const os_communicator::Trace_record &record){
+    const char *verdict = record.verdict == decoder::VERDICT_ACCEPT ? "accept" : record.verdict == decoder::VERDICT_TRUNCATE ? "truncate" : "drop";
+
+    printf("===== trace %lu - %s - %s (%s) =====\n",
+        (unsigned long) record.index,
+        format_timestamp(record.timestamp).c_str(),
+        verdict,
+        decoder::Validator::get_name((decoder::Validation_reason) record.reason));
+
+    decoder::Frame frame;
+    frame.set_raw_data(record.frame.data(), record.frame.size());
+
+    decoder::Validator validator;
+    if(frame.validate(validator) == decoder::VERDICT_DROP){
+        frame.print_raw_data();
+    } else {
+        try{
+            frame.decode();
+            frame.print();
+        } catch(const std::exception &e){
+            printf("Error while decoding: %s\n", e.what());
+            frame.print_raw_data();
+        }
+    }
+
+    printf("Output: %s\n", record.output.c_str());
+}
+
+int main(int argc, char *argv[]){
+    if(argc < 2 || argc > 3){
+        fprintf(stderr, "Usage: %s <trace file> [count]\n", argv[0]);
+        return 1;
+    }
+
+    try{
+        os_communicator::Trace_ring ring(argv[1]);
+
+        uint64_t write_index = ring.get_write_index();
+        uint64_t count = argc == 3 ? std::stoul(argv[2]) : ring.get_slot_count();
+        count = std::min<uint64_t>(count, std::min<uint64_t>(write_index, ring.get_slot_count()));
+
+        os_communicator::Trace_record record;
+        for(uint64_t index = write_index - count; index < write_index; ++index){
+            // The slot has been overwritten or is being written
+            if(!ring.read(index, record))
+                continue;
+
+            print_record(record);
+        }
+    } catch(const std::exception &e){
+        fprintf(stderr, "Error: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}